@@ -0,0 +1,69 @@
+#include "benchmark/benchmark.h"
+#include "tess.hpp"
+#include "inputs.hpp"
+#include <array>
+
+using namespace tess;
+
+template<std::floating_point R, HexTop TopStyle>
+Basis<R, TopStyle> const basis{R(400), R(300), R(16)};
+
+template<std::floating_point R, HexTop TopStyle, typename Field>
+void BM_BasisPixel(benchmark::State & state)
+{
+    auto const & b = basis<R, TopStyle>;
+    auto const hexes = random_hexes<Field>(state.range(0), Field(1000));
+    for (auto _ : state) {
+        for (auto const & h : hexes) {
+            benchmark::DoNotOptimize(b.template pixel<point<R>>(h));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<std::floating_point R, HexTop TopStyle, typename Field>
+void BM_BasisHex(benchmark::State & state)
+{
+    auto const & b = basis<R, TopStyle>;
+    auto const points = random_points<Field>(state.range(0), Field(10000));
+    for (auto _ : state) {
+        for (auto const & p : points) {
+            benchmark::DoNotOptimize(b.hex(p));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<std::floating_point R, HexTop TopStyle, typename Field>
+void BM_BasisVertices(benchmark::State & state)
+{
+    auto const & b = basis<R, TopStyle>;
+    auto const hexes = random_hexes<Field>(state.range(0), Field(1000));
+    std::array<point<R>, 6> corners;
+    for (auto _ : state) {
+        for (auto const & h : hexes) {
+            b.template vertices<point<R>>(h, corners.begin());
+            benchmark::DoNotOptimize(corners);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#define TESS_BASIS_BENCHMARK(name, R, field)                                \
+    BENCHMARK(name<R, HexTop::Pointed, field>)->Range(64, 64 << 10);        \
+    BENCHMARK(name<R, HexTop::Flat, field>)->Range(64, 64 << 10)
+
+TESS_BASIS_BENCHMARK(BM_BasisPixel, float, int);
+TESS_BASIS_BENCHMARK(BM_BasisPixel, float, float);
+TESS_BASIS_BENCHMARK(BM_BasisPixel, double, int);
+TESS_BASIS_BENCHMARK(BM_BasisPixel, double, double);
+
+TESS_BASIS_BENCHMARK(BM_BasisHex, float, int);
+TESS_BASIS_BENCHMARK(BM_BasisHex, float, float);
+TESS_BASIS_BENCHMARK(BM_BasisHex, double, int);
+TESS_BASIS_BENCHMARK(BM_BasisHex, double, double);
+
+TESS_BASIS_BENCHMARK(BM_BasisVertices, float, int);
+TESS_BASIS_BENCHMARK(BM_BasisVertices, float, float);
+TESS_BASIS_BENCHMARK(BM_BasisVertices, double, int);
+TESS_BASIS_BENCHMARK(BM_BasisVertices, double, double);
@@ -0,0 +1,88 @@
+#include "benchmark/benchmark.h"
+#include "tess.hpp"
+#include "inputs.hpp"
+#include <vector>
+#include <iterator>
+#include <functional>
+
+using namespace tess;
+
+template<typename Field>
+void BM_HexNorm(benchmark::State & state)
+{
+    auto const hexes = random_hexes<Field>(state.range(0), Field(1000));
+    for (auto _ : state) {
+        for (auto const & h : hexes) {
+            benchmark::DoNotOptimize(hex_norm(h));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HexNorm<int>)->Range(64, 64 << 10);
+BENCHMARK(BM_HexNorm<float>)->Range(64, 64 << 10);
+BENCHMARK(BM_HexNorm<double>)->Range(64, 64 << 10);
+
+template<typename Field>
+void BM_HexHash(benchmark::State & state)
+{
+    auto const hexes = random_hexes<Field>(state.range(0), Field(1000));
+    std::hash<hex<Field>> const hash;
+    for (auto _ : state) {
+        for (auto const & h : hexes) {
+            benchmark::DoNotOptimize(hash(h));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HexHash<int>)->Range(64, 64 << 10);
+BENCHMARK(BM_HexHash<float>)->Range(64, 64 << 10);
+BENCHMARK(BM_HexHash<double>)->Range(64, 64 << 10);
+
+template<std::integral Integer, std::floating_point Real>
+void BM_HexRound(benchmark::State & state)
+{
+    auto const hexes = random_hexes<Real>(state.range(0), Real(1000));
+    for (auto _ : state) {
+        for (auto const & h : hexes) {
+            benchmark::DoNotOptimize(hex_round<Integer>(h));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HexRound<int, float>)->Range(64, 64 << 10);
+BENCHMARK(BM_HexRound<int, double>)->Range(64, 64 << 10);
+BENCHMARK(BM_HexRound<long, double>)->Range(64, 64 << 10);
+
+// lines and ranges are measured by their length and radius
+template<std::integral Integer>
+void BM_Line(benchmark::State & state)
+{
+    hex<Integer> const a{-3, 7};
+    hex<Integer> const b = a + hex<Integer>{static_cast<Integer>(state.range(0)),
+                                            static_cast<Integer>(-state.range(0)/3)};
+    std::vector<hex<Integer>> hexes;
+    for (auto _ : state) {
+        hexes.clear();
+        line(a, b, std::back_inserter(hexes));
+        benchmark::DoNotOptimize(hexes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * hexes.size());
+}
+BENCHMARK(BM_Line<int>)->RangeMultiplier(4)->Range(4, 4 << 10);
+BENCHMARK(BM_Line<long>)->RangeMultiplier(4)->Range(4, 4 << 10);
+
+template<std::integral Integer>
+void BM_HexRange(benchmark::State & state)
+{
+    hex<Integer> const center{5, -2};
+    auto const radius = static_cast<Integer>(state.range(0));
+    std::vector<hex<Integer>> hexes;
+    for (auto _ : state) {
+        hexes.clear();
+        hex_range(center, radius, std::back_inserter(hexes));
+        benchmark::DoNotOptimize(hexes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * hexes.size());
+}
+BENCHMARK(BM_HexRange<int>)->RangeMultiplier(4)->Range(1, 256);
+BENCHMARK(BM_HexRange<long>)->RangeMultiplier(4)->Range(1, 256);
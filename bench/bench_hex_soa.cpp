@@ -0,0 +1,42 @@
+#include "benchmark/benchmark.h"
+#include "tess.hpp"
+#include "inputs.hpp"
+#include <vector>
+
+using namespace tess;
+
+// the same bulk distances, over interleaved and separate components
+template<typename Field>
+void BM_DistanceArray(benchmark::State & state)
+{
+    auto const hexes = random_hexes<Field>(state.range(0), Field(1000));
+    hex<Field> const offset{Field(3), Field(-7)};
+    std::vector<Field> norms(hexes.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < hexes.size(); ++i) {
+            norms[i] = hex_norm(hexes[i] - offset);
+        }
+        benchmark::DoNotOptimize(norms.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DistanceArray<int>)->Range(64, 256 << 10);
+BENCHMARK(BM_DistanceArray<float>)->Range(64, 256 << 10);
+
+template<typename Field>
+void BM_DistanceSoa(benchmark::State & state)
+{
+    hex_soa<Field> const hexes{
+        random_hexes<Field>(state.range(0), Field(1000))};
+    hex<Field> const offset{Field(3), Field(-7)};
+    std::vector<Field> norms(hexes.size());
+    for (auto _ : state) {
+        hex_distance(hexes, offset, std::span<Field>{norms});
+        benchmark::DoNotOptimize(norms.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DistanceSoa<int>)->Range(64, 256 << 10);
+BENCHMARK(BM_DistanceSoa<float>)->Range(64, 256 << 10);
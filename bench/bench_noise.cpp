@@ -0,0 +1,42 @@
+#include "benchmark/benchmark.h"
+#include "tess.hpp"
+#include <vector>
+
+using namespace tess;
+
+// one sample per tile through the scalar call, against whole grids at once
+void BM_NoisePerTile(benchmark::State & state)
+{
+    pointed_fbasis const basis{0.f, 0.f, 8.f};
+    simplex_noise const noise{1};
+    hex_grid<float> tiles{hex<int>::zero, int(state.range(0)),
+                          int(state.range(0))};
+    for (auto _ : state) {
+        for (int r = 0; r < tiles.height(); ++r) {
+            for (int q = 0; q < tiles.width(); ++q) {
+                hex<int> const h{q, r};
+                auto const p = basis.position(h);
+                tiles[h] = noise(p.x / 100.f, p.y / 100.f);
+            }
+        }
+        benchmark::DoNotOptimize(tiles.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * tiles.size());
+}
+BENCHMARK(BM_NoisePerTile)->Range(64, 1024);
+
+void BM_FillNoise(benchmark::State & state)
+{
+    pointed_fbasis const basis{0.f, 0.f, 8.f};
+    simplex_noise const noise{1};
+    hex_grid<float> tiles{hex<int>::zero, int(state.range(0)),
+                          int(state.range(0))};
+    for (auto _ : state) {
+        fill_noise(tiles, basis, noise, 1/100.f, 1, 1);
+        benchmark::DoNotOptimize(tiles.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * tiles.size());
+}
+BENCHMARK(BM_FillNoise)->Range(64, 1024);
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "tess.hpp"
+#include <random>
+#include <vector>
+#include <cstddef>
+
+// random inputs, generated once per size so every run sees the same values
+template<typename Field>
+std::vector<tess::hex<Field>> random_hexes(std::size_t count, Field extent)
+{
+    std::mt19937 random{static_cast<unsigned>(count)};
+    std::vector<tess::hex<Field>> hexes;
+    hexes.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if constexpr (std::integral<Field>) {
+            std::uniform_int_distribution<Field> coord{-extent, extent};
+            hexes.push_back(tess::hex<Field>{coord(random), coord(random)});
+        }
+        else {
+            std::uniform_real_distribution<Field> coord{-extent, extent};
+            hexes.push_back(tess::hex<Field>{coord(random), coord(random)});
+        }
+    }
+    return hexes;
+}
+
+template<typename Field>
+std::vector<tess::point<Field>> random_points(std::size_t count, Field extent)
+{
+    std::mt19937 random{static_cast<unsigned>(count) + 1};
+    std::uniform_real_distribution<double> coord{-static_cast<double>(extent),
+                                                static_cast<double>(extent)};
+    std::vector<tess::point<Field>> points;
+    points.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        points.push_back(tess::point<Field>{static_cast<Field>(coord(random)),
+                                            static_cast<Field>(coord(random))});
+    }
+    return points;
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <concepts>
+#include <array>
+#include <vector>
+#include <bit>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "hex.hpp"
+#include "grid.hpp"
+#include "parallel.hpp"
+
+namespace tess {
+
+/**
+ * A cellular automaton over a dense grid of hex tiles.
+ *
+ * Each step calculates every tile's next state from its current state and
+ * the states of its six neighbors. The next states are written to a second
+ * grid, which then becomes the current one, so a step never reads a state it
+ * has already changed. Steps are split between threads by bands of rows;
+ * because every band only reads from the current grid, neighbors across a
+ * band's edge need no extra synchronization.
+ *
+ * \code{.cpp}
+ * hex_automaton<float> fire{hex<int>::zero, 512, 512, 0.f};
+ * fire.cells()[ignition] = 1.f;
+ * fire.step([](float heat, std::array<float, 6> const & around) {
+ *     return std::max(heat * 0.9f, *std::max_element(around.begin(),
+ *                                                    around.end()) * 0.5f);
+ * });
+ * \endcode
+ */
+template<typename State>
+class hex_automaton {
+public:
+    /**
+     * Create a `width` by `height` automaton at `origin` with every tile in
+     * `initial`.
+     *
+     * Neighbors outside of the grid are treated as being in `boundary`.
+     *
+     * \throws std::invalid_argument if `width` or `height` is negative.
+     */
+    hex_automaton(hex<int> const & origin, int width, int height,
+                  State const & initial = State{},
+                  State const & boundary = State{})
+
+        : _current{origin, width, height, initial},
+          _next{origin, width, height, initial},
+          _boundary{boundary}
+    {
+    }
+
+    /** The current state of every tile. */
+    hex_grid<State> & cells() noexcept { return _current; }
+    hex_grid<State> const & cells() const noexcept { return _current; }
+
+    /**
+     * Advance every tile by one step.
+     *
+     * `rule` is called as `rule(state, neighbors)` where `neighbors` is a
+     * `std::array<State, 6>` ordered like `hex_directions`, and returns the
+     * tile's next state. It may be called from several threads at once.
+     */
+    template<typename Rule>
+    requires std::convertible_to<
+        std::invoke_result_t<Rule &, State const &,
+                             std::array<State, 6> const &>, State>
+    void step(Rule && rule, unsigned threads = default_threads())
+    {
+        int const width = _current.width();
+        auto const rows = static_cast<std::size_t>(_current.height());
+        parallel_for(rows, threads,
+            [&](std::size_t, std::size_t first, std::size_t last) {
+                for (auto r = first; r < last; ++r) {
+                    step_row(static_cast<int>(r), width, rule);
+                }
+            });
+        std::swap(_current, _next);
+    }
+
+private:
+    hex_grid<State> _current;
+    hex_grid<State> _next;
+    State _boundary;
+
+    template<typename Rule>
+    void step_row(int r, int width, Rule & rule)
+    {
+        auto const row = _current.row(r);
+        auto const into = _next.row(r);
+        bool const has_above = r > 0;
+        bool const has_below = r+1 < _current.height();
+        State const * const above = has_above? _current.row(r-1).data()
+                                             : nullptr;
+        State const * const below = has_below? _current.row(r+1).data()
+                                             : nullptr;
+
+        std::array<State, 6> around;
+        for (int q = 0; q < width; ++q) {
+            bool const west = q > 0;
+            bool const east = q+1 < width;
+            around[0] = east? row[q+1] : _boundary;
+            around[1] = has_above and east? above[q+1] : _boundary;
+            around[2] = has_above? above[q] : _boundary;
+            around[3] = west? row[q-1] : _boundary;
+            around[4] = has_below and west? below[q-1] : _boundary;
+            around[5] = has_below? below[q] : _boundary;
+            into[q] = rule(row[q], around);
+        }
+    }
+};
+
+/**
+ * A rule for a binary automaton based on how many neighbors are alive.
+ *
+ * A dead tile with `n` live neighbors comes alive if `birth[n]`, and a live
+ * tile with `n` live neighbors stays alive if `survive[n]`.
+ */
+struct count_rule {
+    std::array<bool, 7> birth;
+    std::array<bool, 7> survive;
+};
+
+/**
+ * A cellular automaton whose tiles are either alive or dead.
+ *
+ * States are packed 64 tiles to a word, row by row, and a step updates a
+ * whole word of tiles at once: the six neighbor words are added together
+ * bitwise into a three bit count per tile, which is then matched against the
+ * rule. Tiles outside of the grid are always dead.
+ *
+ * \code{.cpp}
+ * binary_automaton life{hex<int>::zero, 1024, 1024};
+ * life.set(hex<int>{10, 10}, true);
+ * life.step(count_rule{{0, 0, 1, 0, 0, 0, 0}, {0, 0, 1, 1, 0, 0, 0}});
+ * \endcode
+ */
+class binary_automaton {
+public:
+    /**
+     * Create a `width` by `height` automaton at `origin` with every tile dead.
+     *
+     * \throws std::invalid_argument if `width` or `height` is negative.
+     */
+    binary_automaton(hex<int> const & origin, int width, int height)
+
+        : _origin{origin}, _width{width}, _height{height},
+          _stride{(static_cast<std::size_t>(width) + 63) / 64}
+    {
+        if (width < 0 or height < 0) {
+            throw std::invalid_argument{
+                "automaton dimensions must not be negative"};
+        }
+        _current.assign(_stride * height, 0);
+        _next.assign(_stride * height, 0);
+    }
+
+    /** The hex of the first tile of this automaton. */
+    hex<int> origin() const noexcept { return _origin; }
+
+    /** The number of tiles in each row of this automaton. */
+    int width() const noexcept { return _width; }
+
+    /** The number of rows in this automaton. */
+    int height() const noexcept { return _height; }
+
+    /** Determine if `h` lies within the bounds of this automaton. */
+    bool contains(hex<int> const & h) const noexcept
+    {
+        int const q = h.q - _origin.q;
+        int const r = h.r - _origin.r;
+        return 0 <= q and q < _width and 0 <= r and r < _height;
+    }
+
+    /** Determine if `h` is alive. Tiles outside of the bounds are dead. */
+    bool alive(hex<int> const & h) const noexcept
+    {
+        if (not contains(h)) {
+            return false;
+        }
+        auto const [word, bit] = locate(h);
+        return (_current[word] >> bit) & 1;
+    }
+
+    /**
+     * Set whether `h` is alive.
+     *
+     * \throws std::out_of_range if `h` isn't within the bounds.
+     */
+    void set(hex<int> const & h, bool alive)
+    {
+        if (not contains(h)) {
+            throw std::out_of_range{"hex is outside of the automaton"};
+        }
+        auto const [word, bit] = locate(h);
+        std::uint64_t const mask = std::uint64_t{1} << bit;
+        _current[word] = alive? _current[word] | mask : _current[word] & ~mask;
+    }
+
+    /** The number of live tiles. */
+    std::size_t count() const noexcept
+    {
+        std::size_t total = 0;
+        for (auto word : _current) {
+            total += static_cast<std::size_t>(std::popcount(word));
+        }
+        return total;
+    }
+
+    /** The packed states, `row_words()` words per row. */
+    std::uint64_t const * data() const noexcept { return _current.data(); }
+
+    /** The number of words in each packed row. */
+    std::size_t row_words() const noexcept { return _stride; }
+
+    /** Advance every tile by one step of `rule`. */
+    void step(count_rule const & rule, unsigned threads = default_threads())
+    {
+        auto const rows = static_cast<std::size_t>(_height);
+        parallel_for(rows, threads,
+            [&](std::size_t, std::size_t first, std::size_t last) {
+                for (auto r = first; r < last; ++r) {
+                    step_row(r, rule);
+                }
+            });
+        std::swap(_current, _next);
+    }
+
+private:
+    hex<int> _origin;
+    int _width;
+    int _height;
+    std::size_t _stride;
+    std::vector<std::uint64_t> _current;
+    std::vector<std::uint64_t> _next;
+
+    std::pair<std::size_t, int> locate(hex<int> const & h) const noexcept
+    {
+        auto const q = static_cast<std::size_t>(h.q - _origin.q);
+        auto const r = static_cast<std::size_t>(h.r - _origin.r);
+        return {r*_stride + q/64, static_cast<int>(q % 64)};
+    }
+
+    // the state of tile q-1 at bit q, and of tile q+1 at bit q
+    static std::uint64_t from_west(std::uint64_t const * row, std::size_t i)
+    {
+        return (row[i] << 1) | (i > 0? row[i-1] >> 63 : 0);
+    }
+    std::uint64_t from_east(std::uint64_t const * row, std::size_t i) const
+    {
+        return (row[i] >> 1) | (i+1 < _stride? row[i+1] << 63 : 0);
+    }
+
+    void step_row(std::size_t r, count_rule const & rule)
+    {
+        std::uint64_t const * const row = _current.data() + r*_stride;
+        std::uint64_t const * const above = r > 0? row - _stride : nullptr;
+        std::uint64_t const * const below =
+            r+1 < static_cast<std::size_t>(_height)? row + _stride : nullptr;
+        std::uint64_t * const into = _next.data() + r*_stride;
+
+        for (std::size_t i = 0; i < _stride; ++i) {
+            std::array<std::uint64_t, 6> const around{
+                from_east(row, i),
+                above? from_east(above, i) : 0,
+                above? above[i] : 0,
+                from_west(row, i),
+                below? from_west(below, i) : 0,
+                below? below[i] : 0
+            };
+
+            // add the six neighbor bits of every tile into a 3 bit count
+            std::uint64_t c0 = 0, c1 = 0, c2 = 0;
+            for (auto const n : around) {
+                std::uint64_t const carry0 = c0 & n;
+                c0 ^= n;
+                std::uint64_t const carry1 = c1 & carry0;
+                c1 ^= carry0;
+                c2 |= carry1;
+            }
+
+            std::uint64_t born = 0;
+            std::uint64_t kept = 0;
+            for (int n = 0; n < 7; ++n) {
+                std::uint64_t const is_n = (n & 1? c0 : ~c0)
+                                         & (n & 2? c1 : ~c1)
+                                         & (n & 4? c2 : ~c2);
+                born |= rule.birth[n]? is_n : 0;
+                kept |= rule.survive[n]? is_n : 0;
+            }
+            into[i] = (row[i] & kept) | (~row[i] & born);
+        }
+
+        // keep the padding past the last tile dead
+        if (int const used = _width % 64; used != 0 and _stride > 0) {
+            into[_stride-1] &= (std::uint64_t{1} << used) - 1;
+        }
+    }
+};
+}
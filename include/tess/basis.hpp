@@ -2,7 +2,7 @@
 
 #include <type_traits>
 #include <cmath>
-#include <valarray>
+#include <array>
 #include <concepts>
 #include <numbers>
 
@@ -26,8 +26,7 @@ public:
      */
     Basis(R x, R y, R unit_size)
 
-        : _basis{4}, _inverse{4}, x{x}, y{y},
-          _unit_size{unit_size}
+        : x{x}, y{y}, _unit_size{unit_size}
     {
         R sqrt3 = std::sqrt(R(3));
         if (TopStyle == HexTop::Pointed) {
@@ -38,8 +37,8 @@ public:
             _basis = {3/R(2), 0, sqrt3/2, sqrt3};
             _inverse = {2/R(3), 0, -1/R(3), sqrt3/3};
         }
-        _basis *= _unit_size;
-        _inverse /= R(_unit_size);
+        for (auto & e : _basis) { e *= _unit_size; }
+        for (auto & e : _inverse) { e /= R(_unit_size); }
     }
 
     /** The origin of this basis in screen space (pixels). */
@@ -53,18 +52,35 @@ public:
     template<cartesian Point, axial Hex>
     Point pixel(Hex const & h) const noexcept
     {
-        std::valarray<R> hexv{ static_cast<R>(h.q), static_cast<R>(h.r) };
-        std::valarray<R> const hx = _basis[std::slice(0, 2, 1)] * hexv;
-        std::valarray<R> const hy = _basis[std::slice(2, 2, 1)] * hexv;
+        R const q = static_cast<R>(h.q);
+        R const r = static_cast<R>(h.r);
+        R const hx = _basis[0]*q + _basis[1]*r;
+        R const hy = _basis[2]*q + _basis[3]*r;
 
         using Scalar = scalar_field_t<Point>;
-        Point const p{ static_cast<Scalar>(std::round(hx.sum())),
-                       static_cast<Scalar>(std::round(hy.sum())) };
+        Point const p{ static_cast<Scalar>(std::round(hx)),
+                       static_cast<Scalar>(std::round(hy)) };
 
         return Point{ p.x+static_cast<Scalar>(x),
                       p.y+static_cast<Scalar>(y) };
     }
 
+    /**
+     * Convert `h` to its exact position in screen space.
+     *
+     * Unlike `pixel`, the position isn't rounded to a whole pixel, so it
+     * suits sampling continuous functions like noise at hex centers. `h` may
+     * be fractional.
+     */
+    template<axial Hex>
+    point<R> position(Hex const & h) const noexcept
+    {
+        R const q = static_cast<R>(h.q);
+        R const r = static_cast<R>(h.r);
+        return point<R>{ _basis[0]*q + _basis[1]*r + x,
+                         _basis[2]*q + _basis[3]*r + y };
+    }
+
     /**
      * Convert `p` to a point in hex space.
      *
@@ -80,13 +96,11 @@ public:
         Point const p2{ p.x-static_cast<Scalar>(x),
                         p.y-static_cast<Scalar>(y) };
 
-        std::valarray<R> pv{ static_cast<R>(p2.x),
-                             static_cast<R>(p2.y) };
-
-        auto q = _inverse[std::slice(0, 2, 1)] * pv;
-        auto r = _inverse[std::slice(2, 2, 1)] * pv;
+        R const px = static_cast<R>(p2.x);
+        R const py = static_cast<R>(p2.y);
 
-        return tess::hex{q.sum(), r.sum()};
+        return tess::hex{_inverse[0]*px + _inverse[1]*py,
+                         _inverse[2]*px + _inverse[3]*py};
     }
 
     /** Calculate the vertices of `hex` in screen space. */
@@ -105,21 +119,20 @@ public:
             R theta = offset + i * pi/3;
 
             // convert the angle to unit vector, then scale and offset
-            std::valarray<R> v{std::cos(theta), std::sin(theta)};
-            v *= _unit_size;
-            v += std::valarray<R>{ static_cast<R>(center.x),
-                                   static_cast<R>(center.y) };
+            R const vx = std::cos(theta)*_unit_size + static_cast<R>(center.x);
+            R const vy = std::sin(theta)*_unit_size + static_cast<R>(center.y);
 
             using Scalar = scalar_field_t<Point>;
-            *into_verts++ = Point{ static_cast<Scalar>(std::round(v[0])),
-                                   static_cast<Scalar>(std::round(v[1])) };
+            *into_verts++ = Point{ static_cast<Scalar>(std::round(vx)),
+                                   static_cast<Scalar>(std::round(vy)) };
         }
         return into_verts;
     }
 
 private:
-    std::valarray<R> _basis;
-    std::valarray<R> _inverse;
+    // row-major 2x2 matrices from hex space to screen space and back
+    std::array<R, 4> _basis;
+    std::array<R, 4> _inverse;
 
     R x; R y;
     R _unit_size;
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <optional>
+#include <functional>
+#include <bit>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+
+#include "hex.hpp"
+
+namespace tess {
+
+/**
+ * A hash map from hexes to `T` that many threads can use at once.
+ *
+ * Hexes are spread between a fixed number of shards, each an
+ * `std::unordered_map` behind its own lock, so threads working on different
+ * tiles rarely wait on each other. Shards are chosen by mixing both
+ * components of a hex, so neighboring tiles land in different shards and
+ * threads updating overlapping regions still spread their work out.
+ *
+ * Every operation is atomic with respect to a single hex. Operations that
+ * visit the whole map, like `size` and `for_each`, lock one shard at a time
+ * and so see a consistent view of each shard but not of the map as a whole.
+ *
+ * \code{.cpp}
+ * concurrent_hex_map<float> influence;
+ * parallel_for(units.size(), threads, [&](auto, auto first, auto last) {
+ *     for (auto i = first; i < last; ++i) {
+ *         influence.update(units[i].tile, [&](float & value) {
+ *             value += units[i].strength;
+ *         });
+ *     }
+ * });
+ * \endcode
+ */
+template<typename T>
+class concurrent_hex_map {
+public:
+    /**
+     * Create an empty map with `shards` shards.
+     *
+     * More shards make contention between threads less likely. A few times
+     * the number of threads is usually enough.
+     *
+     * \throws std::invalid_argument if `shards` isn't a power of two.
+     */
+    explicit concurrent_hex_map(std::size_t shards = 64)
+
+        : _shards(shards), _shift{64 - std::countr_zero(shards)}
+    {
+        if (not std::has_single_bit(shards)) {
+            throw std::invalid_argument{
+                "concurrent_hex_map shards must be a power of two"};
+        }
+    }
+
+    concurrent_hex_map(concurrent_hex_map const &) = delete;
+    concurrent_hex_map & operator=(concurrent_hex_map const &) = delete;
+
+    /** The number of shards hexes are spread between. */
+    std::size_t shard_count() const noexcept { return _shards.size(); }
+
+    /**
+     * Add `h` with `value` if it isn't already in the map.
+     *
+     * \return true if `h` was added.
+     */
+    bool insert(hex<int> const & h, T const & value)
+    {
+        auto & s = shard_of(h);
+        std::scoped_lock lock{s.mutex};
+        return s.tiles.try_emplace(h, value).second;
+    }
+
+    /**
+     * Set the value of `h`, adding it if it isn't already in the map.
+     *
+     * \return true if `h` was added.
+     */
+    bool insert_or_assign(hex<int> const & h, T const & value)
+    {
+        auto & s = shard_of(h);
+        std::scoped_lock lock{s.mutex};
+        return s.tiles.insert_or_assign(h, value).second;
+    }
+
+    /**
+     * Call `f` on the value of `h` while no other thread can reach it.
+     *
+     * If `h` isn't in the map it's first added with a value of `T{}`. `f`
+     * must not use this map.
+     */
+    template<std::invocable<T &> F>
+    void update(hex<int> const & h, F && f)
+    {
+        auto & s = shard_of(h);
+        std::scoped_lock lock{s.mutex};
+        std::invoke(f, s.tiles[h]);
+    }
+
+    /** A copy of the value of `h`, if it's in the map. */
+    std::optional<T> find(hex<int> const & h) const
+    {
+        auto const & s = shard_of(h);
+        std::scoped_lock lock{s.mutex};
+        auto const found = s.tiles.find(h);
+        if (found == s.tiles.end()) {
+            return std::nullopt;
+        }
+        return found->second;
+    }
+
+    /** Determine if `h` is in the map. */
+    bool contains(hex<int> const & h) const
+    {
+        auto const & s = shard_of(h);
+        std::scoped_lock lock{s.mutex};
+        return s.tiles.contains(h);
+    }
+
+    /**
+     * Remove `h` from the map.
+     *
+     * \return true if `h` was in the map.
+     */
+    bool erase(hex<int> const & h)
+    {
+        auto & s = shard_of(h);
+        std::scoped_lock lock{s.mutex};
+        return s.tiles.erase(h) > 0;
+    }
+
+    /**
+     * Combine every `(hex, value)` element of `tiles` into the map.
+     *
+     * Hexes that aren't in the map are added with their value, and hexes that
+     * are become `combine(current, value)`. The elements are first grouped by
+     * shard, so each shard is locked only once for the whole batch. This is
+     * the cheapest way for a worker to publish many updates at once.
+     *
+     * \code{.cpp}
+     * std::vector<std::pair<hex<int>, int>> local = ...;
+     * population.merge(local, std::plus<>{});
+     * \endcode
+     */
+    template<std::ranges::input_range Tiles, typename Combine = std::plus<>>
+    void merge(Tiles const & tiles, Combine combine = {})
+    {
+        using Element = std::ranges::range_value_t<Tiles>;
+        using Value = std::remove_cvref_t<std::tuple_element_t<1, Element>>;
+
+        std::vector<std::vector<std::pair<hex<int>, Value>>> batches(
+            _shards.size());
+        for (auto const & [h, value] : tiles) {
+            batches[shard_index(h)].emplace_back(h, value);
+        }
+        for (std::size_t i = 0; i < batches.size(); ++i) {
+            if (batches[i].empty()) {
+                continue;
+            }
+            auto & s = _shards[i];
+            std::scoped_lock lock{s.mutex};
+            for (auto const & [h, value] : batches[i]) {
+                auto const [found, added] = s.tiles.try_emplace(h, value);
+                if (not added) {
+                    found->second = combine(found->second, value);
+                }
+            }
+        }
+    }
+
+    /** The number of hexes in the map. */
+    std::size_t size() const
+    {
+        std::size_t total = 0;
+        for (auto const & s : _shards) {
+            std::scoped_lock lock{s.mutex};
+            total += s.tiles.size();
+        }
+        return total;
+    }
+
+    /** Remove every hex from the map. */
+    void clear()
+    {
+        for (auto & s : _shards) {
+            std::scoped_lock lock{s.mutex};
+            s.tiles.clear();
+        }
+    }
+
+    /**
+     * Call `f(h, value)` for every tile of the map.
+     *
+     * Each shard is locked while it's visited, so `f` must not use this map.
+     */
+    template<typename F>
+    void for_each(F && f) const
+    {
+        for (auto const & s : _shards) {
+            std::scoped_lock lock{s.mutex};
+            for (auto const & [h, value] : s.tiles) {
+                f(h, value);
+            }
+        }
+    }
+
+    /** Copy every tile of the map into an ordinary map. */
+    std::unordered_map<hex<int>, T> snapshot() const
+    {
+        std::unordered_map<hex<int>, T> tiles;
+        for_each([&tiles](hex<int> const & h, T const & value) {
+            tiles.emplace(h, value);
+        });
+        return tiles;
+    }
+
+private:
+    // shards are kept on separate cache lines so their locks don't contend
+    struct alignas(64) shard {
+        mutable std::mutex mutex;
+        std::unordered_map<hex<int>, T> tiles;
+    };
+
+    std::vector<shard> _shards;
+    int _shift;
+
+    std::size_t shard_index(hex<int> const & h) const noexcept
+    {
+        // the high bits of a multiplicative hash of both components
+        std::uint64_t const mixed = detail::mix(h);
+        return _shift >= 64? 0 : static_cast<std::size_t>(mixed >> _shift);
+    }
+
+    shard & shard_of(hex<int> const & h) noexcept
+    {
+        return _shards[shard_index(h)];
+    }
+
+    shard const & shard_of(hex<int> const & h) const noexcept
+    {
+        return _shards[shard_index(h)];
+    }
+};
+}
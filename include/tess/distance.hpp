@@ -0,0 +1,94 @@
+#pragma once
+
+#include <concepts>
+#include <algorithm>
+#include <cstddef>
+
+#include "hex.hpp"
+#include "grid.hpp"
+
+namespace tess {
+
+/**
+ * Calculate the hex distance from every tile of `distances` to its nearest
+ * seed.
+ *
+ * Every tile of `distances` that is zero is treated as a seed, and every other
+ * tile is overwritten with `hex_norm(h - seed)` for the nearest seed. If there
+ * are no seeds, every tile is set to `width() + height()`, which is larger
+ * than any distance within the grid.
+ *
+ * The transform is computed with two raster sweeps. Each sweep first relaxes a
+ * whole row against its already-finished neighbor row, which is a branchless
+ * loop over contiguous memory, then propagates along the row itself.
+ */
+template<std::integral Integer>
+void distance_transform(hex_grid<Integer> & distances) noexcept
+{
+    int const width = distances.width();
+    int const height = distances.height();
+    Integer const far = static_cast<Integer>(width + height);
+
+    Integer * const tiles = distances.data();
+    std::size_t const n = distances.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        tiles[i] = tiles[i] == 0? Integer{0} : far;
+    }
+
+    // forward sweep: relax against (q, r-1), (q+1, r-1) and (q-1, r)
+    for (int r = 0; r < height; ++r) {
+        Integer * const row = tiles + static_cast<std::size_t>(r) * width;
+        if (r > 0) {
+            Integer const * const above = row - width;
+            for (int q = 0; q < width; ++q) {
+                row[q] = std::min<Integer>(row[q], above[q] + 1);
+            }
+            for (int q = 0; q < width - 1; ++q) {
+                row[q] = std::min<Integer>(row[q], above[q+1] + 1);
+            }
+        }
+        for (int q = 1; q < width; ++q) {
+            row[q] = std::min<Integer>(row[q], row[q-1] + 1);
+        }
+    }
+
+    // backward sweep: relax against (q, r+1), (q-1, r+1) and (q+1, r)
+    for (int r = height-1; r >= 0; --r) {
+        Integer * const row = tiles + static_cast<std::size_t>(r) * width;
+        if (r < height-1) {
+            Integer const * const below = row + width;
+            for (int q = 0; q < width; ++q) {
+                row[q] = std::min<Integer>(row[q], below[q] + 1);
+            }
+            for (int q = 1; q < width; ++q) {
+                row[q] = std::min<Integer>(row[q], below[q-1] + 1);
+            }
+        }
+        for (int q = width-2; q >= 0; --q) {
+            row[q] = std::min<Integer>(row[q], row[q+1] + 1);
+        }
+    }
+}
+
+/**
+ * Calculate the hex distance from every tile of `tiles` to the nearest tile
+ * for which `is_seed` holds.
+ *
+ * \code{.cpp}
+ * auto const to_coast = distance_transform<int>(terrain, [](auto const & t) {
+ *     return t == terrain_type::coast;
+ * });
+ * \endcode
+ */
+template<std::integral Integer, typename T, std::predicate<T const &> Pred>
+hex_grid<Integer> distance_transform(hex_grid<T> const & tiles, Pred is_seed)
+{
+    hex_grid<Integer> distances{tiles.origin(), tiles.width(), tiles.height()};
+    auto into = distances.begin();
+    for (auto const & tile : tiles) {
+        *into++ = is_seed(tile)? Integer{0} : Integer{1};
+    }
+    distance_transform(distances);
+    return distances;
+}
+}
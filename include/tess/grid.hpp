@@ -0,0 +1,154 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#include "math.hpp"
+#include "hex.hpp"
+
+namespace tess {
+
+/**
+ * A dense grid of tiles over a parallelogram of hex space.
+ *
+ * The grid covers every hex `h` with `origin.q <= h.q < origin.q + width` and
+ * `origin.r <= h.r < origin.r + height`. Tiles are stored row-major by `r`, so
+ * the six neighbors of a tile are always at the same flat index offsets:
+ * `±1`, `±width` and `±(width - 1)`.
+ *
+ * \code{.cpp}
+ * hex_grid<float> heat{hex<int>{-10, -10}, 21, 21};
+ * heat[hex<int>::zero] = 1.f;
+ * \endcode
+ */
+template<typename T>
+class hex_grid {
+public:
+    using value_type = T;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /** Create an empty grid. */
+    hex_grid() noexcept : _origin{hex<int>::zero}, _width{0}, _height{0} {}
+
+    /**
+     * Create a grid of `width` by `height` tiles whose first tile is at
+     * `origin`, with every tile set to `value`.
+     *
+     * \throws std::invalid_argument if `width` or `height` is negative.
+     */
+    hex_grid(hex<int> const & origin, int width, int height,
+             T const & value = T{})
+
+        : _origin{origin}, _width{width}, _height{height}
+    {
+        if (width < 0 or height < 0) {
+            throw std::invalid_argument{"hex_grid dimensions must not be negative"};
+        }
+        _tiles.assign(static_cast<std::size_t>(width) * height, value);
+    }
+
+    /** The hex of the first tile in this grid. */
+    hex<int> origin() const noexcept { return _origin; }
+
+    /** The number of tiles in each row of this grid. */
+    int width() const noexcept { return _width; }
+
+    /** The number of rows in this grid. */
+    int height() const noexcept { return _height; }
+
+    /** The total number of tiles in this grid. */
+    std::size_t size() const noexcept { return _tiles.size(); }
+
+    /** Determine if `h` lies within the bounds of this grid. */
+    bool contains(hex<int> const & h) const noexcept
+    {
+        int const q = h.q - _origin.q;
+        int const r = h.r - _origin.r;
+        return 0 <= q and q < _width and 0 <= r and r < _height;
+    }
+
+    /**
+     * The flat index of `h` in this grid.
+     *
+     * `h` must lie within the bounds of this grid.
+     */
+    std::size_t index(hex<int> const & h) const noexcept
+    {
+        return static_cast<std::size_t>(h.r - _origin.r) * _width
+             + static_cast<std::size_t>(h.q - _origin.q);
+    }
+
+    /** The hex at flat index `i` of this grid. */
+    hex<int> hex_at(std::size_t i) const noexcept
+    {
+        int const q = static_cast<int>(i % _width);
+        int const r = static_cast<int>(i / _width);
+        return hex<int>{_origin.q + q, _origin.r + r};
+    }
+
+    /** The tile at `h`, which must lie within the bounds of this grid. */
+    T & operator[](hex<int> const & h) noexcept { return _tiles[index(h)]; }
+    T const & operator[](hex<int> const & h) const noexcept
+    {
+        return _tiles[index(h)];
+    }
+
+    /**
+     * The tile at `h`.
+     *
+     * \throws std::out_of_range if `h` isn't within the bounds of this grid.
+     */
+    T & at(hex<int> const & h)
+    {
+        if (not contains(h)) {
+            throw std::out_of_range{"hex is outside of the grid"};
+        }
+        return (*this)[h];
+    }
+    T const & at(hex<int> const & h) const
+    {
+        if (not contains(h)) {
+            throw std::out_of_range{"hex is outside of the grid"};
+        }
+        return (*this)[h];
+    }
+
+    /** The `i`th row of this grid, counting from the origin. */
+    std::span<T> row(int i) noexcept
+    {
+        return std::span<T>{_tiles.data() + static_cast<std::size_t>(i)*_width,
+                            static_cast<std::size_t>(_width)};
+    }
+    std::span<T const> row(int i) const noexcept
+    {
+        return std::span<T const>{
+            _tiles.data() + static_cast<std::size_t>(i)*_width,
+            static_cast<std::size_t>(_width)};
+    }
+
+    /** The tiles of this grid in flat index order. */
+    T * data() noexcept { return _tiles.data(); }
+    T const * data() const noexcept { return _tiles.data(); }
+
+    iterator begin() noexcept { return _tiles.begin(); }
+    iterator end() noexcept { return _tiles.end(); }
+    const_iterator begin() const noexcept { return _tiles.begin(); }
+    const_iterator end() const noexcept { return _tiles.end(); }
+
+    /** Set every tile of this grid to `value`. */
+    void fill(T const & value)
+    {
+        std::fill(_tiles.begin(), _tiles.end(), value);
+    }
+
+private:
+    hex<int> _origin;
+    int _width;
+    int _height;
+    std::vector<T> _tiles;
+};
+}
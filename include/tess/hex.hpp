@@ -2,14 +2,15 @@
 
 #include <type_traits>  // is_arithmetic
 #include <cmath>        // abs, sqrt, sqrtf
-#include <algorithm>    // max_element
-#include <numeric>
-#include <valarray>
+#include <algorithm>    // max, min
 #include <iterator>
+#include <array>
+#include <limits>
 
 #include "math.hpp"
 #include <tuple>
 #include <cstddef>
+#include <cstdint>
 
 namespace tess {
 
@@ -36,7 +37,7 @@ namespace tess {
 template<numeric Field>
 struct hex {
     /** The s component of this hex. */
-    Field s() const noexcept { return -q-r; }
+    constexpr Field s() const noexcept { return -q-r; }
     Field q, r;
 
     /** The zero hex */
@@ -76,18 +77,71 @@ constexpr hex<Field> const hex<Field>::back_right{-1, 1};
 template<numeric Field>
 constexpr hex<Field> const hex<Field>::back_up{-1, 0};
 
+/**
+ * The six unit directions, each one a sixth of a turn from the last.
+ *
+ * Neighboring directions sum to the direction between them, so
+ * `hex_directions[i-1] + hex_directions[i+1] == hex_directions[i]` when the
+ * indices are taken modulo 6.
+ */
+template<numeric Field>
+constexpr std::array<hex<Field>, 6> hex_directions{
+    hex<Field>::forward_down, hex<Field>::forward_left, hex<Field>::left_up,
+    hex<Field>::back_up, hex<Field>::back_right, hex<Field>::right_down
+};
+
 template<numeric Field>
 hex(Field, Field) -> hex<Field>;
 
+namespace detail {
+
+// std::abs and std::round aren't usable in constant expressions until C++23
+// and C++26 respectively, so constant evaluation uses these instead
+template<numeric Field>
+constexpr Field abs(Field x) noexcept
+{
+    return x < 0? -x : x;
+}
+
+template<std::floating_point Real>
+constexpr Real round(Real x) noexcept
+{
+    if consteval {
+        // anything this large is already a whole number
+        Real constexpr whole = Real(1) / std::numeric_limits<Real>::epsilon();
+        if (not (abs(x) < whole)) {
+            return x;
+        }
+        auto const truncated = static_cast<Real>(static_cast<long long>(x));
+        Real const rest = x - truncated;
+        return rest >= Real(0.5)? truncated + 1
+             : rest <= Real(-0.5)? truncated - 1
+             : truncated;
+    }
+    else {
+        return std::round(x);
+    }
+}
+
+// a multiplicative hash of both components, whose high bits differ even
+// between neighboring hexes, unlike std::hash<hex>
+constexpr std::uint64_t mix(hex<int> const & h) noexcept
+{
+    std::uint64_t const q = static_cast<std::uint32_t>(h.q);
+    std::uint64_t const r = static_cast<std::uint32_t>(h.r);
+    return (q << 32 | r) * 0x9e3779b97f4a7c15ull;
+}
+}
+
 /**
  * Calculate the hex norm of h.
  *
  * This is equivalent to \f$\frac{|h_q| + |h_r| + |h_s|}{2}\f$
  */
 template<numeric Field>
-Field hex_norm(const hex<Field>& h) noexcept
+constexpr Field hex_norm(const hex<Field>& h) noexcept
 {
-    return (std::abs(h.q) + std::abs(h.r) + std::abs(h.s()))/2;
+    return (detail::abs(h.q) + detail::abs(h.r) + detail::abs(h.s()))/2;
 }
 
 /**
@@ -95,26 +149,29 @@ Field hex_norm(const hex<Field>& h) noexcept
  * integers.
  */
 template<std::integral Integer, std::floating_point Real>
-hex<Integer> hex_round(const hex<Real>& h)
+constexpr hex<Integer> hex_round(const hex<Real>& h)
 {
-    // convert hex to valarray for easy operations
-    std::valarray<Real> v{h.q, h.r, h.s()};
-
     // round each component
-    auto rv = v;
-    std::transform(std::begin(v), std::end(v), std::begin(rv),
-                   [](Real e) { return std::round(e); });
+    Real const q = detail::round(h.q);
+    Real const r = detail::round(h.r);
+    Real const s = detail::round(h.s());
 
     // take the difference between the original and the rounded
-    std::valarray<Real> dv{std::abs(rv-v)};
-
-    // find the max difference and correct it
-    auto i = std::distance(std::begin(dv),
-                           std::max_element(std::begin(dv), std::end(dv)));
-    rv[i] -= std::accumulate(std::begin(rv), std::end(rv), 0);
-
-    return hex<Integer>{static_cast<Integer>(rv[0]),
-                        static_cast<Integer>(rv[1])};
+    Real const dq = detail::abs(q - h.q);
+    Real const dr = detail::abs(r - h.r);
+    Real const ds = detail::abs(s - h.s());
+
+    // the component with the max difference is corrected so that the rounded
+    // components still sum to zero
+    if (dq >= dr and dq >= ds) {
+        return hex<Integer>{static_cast<Integer>(-r-s),
+                            static_cast<Integer>(r)};
+    }
+    if (dr >= ds) {
+        return hex<Integer>{static_cast<Integer>(q),
+                            static_cast<Integer>(-q-s)};
+    }
+    return hex<Integer>{static_cast<Integer>(q), static_cast<Integer>(r)};
 }
 
 /**
@@ -125,7 +182,7 @@ hex<Integer> hex_round(const hex<Real>& h)
  */
 template<axial Hex, std::indirectly_writable<Hex> Out>
 requires std::integral<scalar_field_t<Hex>> and std::weakly_incrementable<Out>
-auto line(const Hex& a, const Hex& b, Out into_hexes) noexcept
+constexpr auto line(const Hex& a, const Hex& b, Out into_hexes) noexcept
 {
     using Integer = scalar_field_t<Hex>;
     auto lerp = [](double a, double b, double t) {
@@ -154,7 +211,8 @@ auto line(const Hex& a, const Hex& b, Out into_hexes) noexcept
  */
 template<axial Hex, std::indirectly_writable<Hex> Out>
 requires std::integral<scalar_field_t<Hex>> and std::weakly_incrementable<Out>
-auto hex_range(const Hex& center, scalar_field_t<Hex> r, Out into_hexes)
+constexpr auto hex_range(const Hex& center, scalar_field_t<Hex> r,
+                         Out into_hexes)
 {
     using Integer = scalar_field_t<Hex>;
     for (Integer i = -r; i <= r; ++i) {
@@ -165,26 +223,98 @@ auto hex_range(const Hex& center, scalar_field_t<Hex> r, Out into_hexes)
     return into_hexes;
 }
 
+/** The number of hexes `hex_range` generates for radius `r`. */
+template<std::integral Integer>
+constexpr std::size_t hex_range_size(Integer r) noexcept
+{
+    auto const n = static_cast<std::size_t>(r);
+    return 3*n*(n+1) + 1;
+}
+
+/**
+ * Calculate the hex coordinates exactly radius `r` from `center`.
+ *
+ * The ring starts at `r` steps in the `back_right` direction from `center`
+ * and walks around it in the order of `hex_directions`. A ring of radius zero
+ * is just `center`.
+ */
+template<axial Hex, std::indirectly_writable<Hex> Out>
+requires std::integral<scalar_field_t<Hex>> and std::weakly_incrementable<Out>
+constexpr auto hex_ring(const Hex& center, scalar_field_t<Hex> r,
+                        Out into_hexes)
+{
+    using Integer = scalar_field_t<Hex>;
+    if (r <= 0) {
+        *into_hexes++ = center;
+        return into_hexes;
+    }
+    Hex h = center + Hex{static_cast<Integer>(-r), r};
+    for (auto const & d : hex_directions<Integer>) {
+        for (Integer i = 0; i < r; ++i) {
+            *into_hexes++ = h;
+            h = h + Hex{d.q, d.r};
+        }
+    }
+    return into_hexes;
+}
+
+/** The number of hexes `hex_ring` generates for radius `r`. */
+template<std::integral Integer>
+constexpr std::size_t hex_ring_size(Integer r) noexcept
+{
+    return r <= 0? 1 : 6*static_cast<std::size_t>(r);
+}
+
+/**
+ * The offsets of every hex within `Radius` of the zero hex, in the order
+ * `hex_range` generates them, calculated at compile time.
+ *
+ * \code{.cpp}
+ * for (auto const & offset : hex_range_offsets<int, 2>) {
+ *     total += grid[center + offset];
+ * }
+ * \endcode
+ */
+template<std::integral Integer, Integer Radius>
+requires (Radius >= 0)
+constexpr auto hex_range_offsets = [] {
+    std::array<hex<Integer>, hex_range_size(Radius)> offsets{};
+    hex_range(hex<Integer>::zero, Radius, offsets.begin());
+    return offsets;
+}();
+
+/**
+ * The offsets of every hex exactly `Radius` from the zero hex, in the order
+ * `hex_ring` generates them, calculated at compile time.
+ */
+template<std::integral Integer, Integer Radius>
+requires (Radius >= 0)
+constexpr auto hex_ring_offsets = [] {
+    std::array<hex<Integer>, hex_ring_size(Radius)> offsets{};
+    hex_ring(hex<Integer>::zero, Radius, offsets.begin());
+    return offsets;
+}();
+
 template<numeric Field>
-bool operator==(const hex<Field>& a, const hex<Field>& b)
+constexpr bool operator==(const hex<Field>& a, const hex<Field>& b)
 {
     return a.q == b.q and a.r == b.r;
 }
 
 template<numeric Field>
-hex<Field> operator+(const hex<Field>& a, const hex<Field>& b)
+constexpr hex<Field> operator+(const hex<Field>& a, const hex<Field>& b)
 {
     return hex<Field>{a.q+b.q, a.r+b.r};
 }
 
 template<numeric Field>
-hex<Field> operator-(const hex<Field>& h)
+constexpr hex<Field> operator-(const hex<Field>& h)
 {
     return hex<Field>{-h.q, -h.r};
 }
 
 template<numeric Field>
-hex<Field> operator-(const hex<Field>& a, const hex<Field>& b)
+constexpr hex<Field> operator-(const hex<Field>& a, const hex<Field>& b)
 {
     return a + (-b);
 }
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <vector>
+#include <bit>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+#include "hex.hpp"
+
+namespace tess {
+
+/**
+ * A set of hexes within a bounded region, stored as one bit per tile.
+ *
+ * The region is the same parallelogram a `hex_grid` covers. Each row is
+ * packed 64 tiles to a word, so combining sets works a whole word of tiles at
+ * a time, and iterating skips straight from one member to the next.
+ *
+ * \code{.cpp}
+ * hex_set visible{origin, 256, 256};
+ * hex_set owned{origin, 256, 256};
+ * ...
+ * for (auto const & h : visible & owned) {
+ *     highlight(h);
+ * }
+ * \endcode
+ */
+class hex_set {
+public:
+    class iterator;
+    using value_type = hex<int>;
+    using const_iterator = iterator;
+
+    /** Create an empty set over an empty region. */
+    hex_set() : hex_set{hex<int>::zero, 0, 0} {}
+
+    /**
+     * Create an empty set over the `width` by `height` region at `origin`.
+     *
+     * \throws std::invalid_argument if `width` or `height` is negative.
+     */
+    hex_set(hex<int> const & origin, int width, int height)
+
+        : _origin{origin}, _width{width}, _height{height},
+          _stride{(static_cast<std::size_t>(std::max(width, 0)) + 63) / 64}
+    {
+        if (width < 0 or height < 0) {
+            throw std::invalid_argument{
+                "hex_set dimensions must not be negative"};
+        }
+        _words.assign(_stride * static_cast<std::size_t>(height), 0);
+    }
+
+    /** The hex of the first tile of the region. */
+    hex<int> origin() const noexcept { return _origin; }
+
+    /** The number of tiles in each row of the region. */
+    int width() const noexcept { return _width; }
+
+    /** The number of rows in the region. */
+    int height() const noexcept { return _height; }
+
+    /** Determine if `h` lies within the region. */
+    bool in_bounds(hex<int> const & h) const noexcept
+    {
+        int const q = h.q - _origin.q;
+        int const r = h.r - _origin.r;
+        return 0 <= q and q < _width and 0 <= r and r < _height;
+    }
+
+    /** Determine if `h` is in this set. */
+    bool contains(hex<int> const & h) const noexcept
+    {
+        if (not in_bounds(h)) {
+            return false;
+        }
+        auto const [word, bit] = locate(h);
+        return (_words[word] >> bit) & 1;
+    }
+
+    /**
+     * Add `h` to this set.
+     *
+     * \throws std::out_of_range if `h` isn't within the region.
+     */
+    void insert(hex<int> const & h)
+    {
+        if (not in_bounds(h)) {
+            throw std::out_of_range{"hex is outside of the hex_set"};
+        }
+        auto const [word, bit] = locate(h);
+        _words[word] |= std::uint64_t{1} << bit;
+    }
+
+    /** Remove `h` from this set, if it's in it. */
+    void erase(hex<int> const & h) noexcept
+    {
+        if (in_bounds(h)) {
+            auto const [word, bit] = locate(h);
+            _words[word] &= ~(std::uint64_t{1} << bit);
+        }
+    }
+
+    /** Remove every hex from this set. */
+    void clear() noexcept { std::ranges::fill(_words, 0); }
+
+    /** The number of hexes in this set. */
+    std::size_t size() const noexcept
+    {
+        std::size_t total = 0;
+        for (auto const word : _words) {
+            total += static_cast<std::size_t>(std::popcount(word));
+        }
+        return total;
+    }
+
+    /** Determine if this set has no hexes. */
+    bool empty() const noexcept
+    {
+        return std::ranges::all_of(_words, [](auto w) { return w == 0; });
+    }
+
+    /**
+     * Add every hex of `other` to this set.
+     *
+     * \throws std::invalid_argument if `other` covers a different region.
+     */
+    hex_set & operator|=(hex_set const & other)
+    {
+        combine(other, [](std::uint64_t a, std::uint64_t b) { return a | b; });
+        return *this;
+    }
+
+    /**
+     * Remove every hex that isn't also in `other` from this set.
+     *
+     * \throws std::invalid_argument if `other` covers a different region.
+     */
+    hex_set & operator&=(hex_set const & other)
+    {
+        combine(other, [](std::uint64_t a, std::uint64_t b) { return a & b; });
+        return *this;
+    }
+
+    /**
+     * Remove every hex of `other` from this set.
+     *
+     * \throws std::invalid_argument if `other` covers a different region.
+     */
+    hex_set & operator-=(hex_set const & other)
+    {
+        combine(other, [](std::uint64_t a, std::uint64_t b) { return a & ~b; });
+        return *this;
+    }
+
+    /**
+     * Keep the hexes in exactly one of this set and `other`.
+     *
+     * \throws std::invalid_argument if `other` covers a different region.
+     */
+    hex_set & operator^=(hex_set const & other)
+    {
+        combine(other, [](std::uint64_t a, std::uint64_t b) { return a ^ b; });
+        return *this;
+    }
+
+    friend hex_set operator|(hex_set a, hex_set const & b) { return a |= b; }
+    friend hex_set operator&(hex_set a, hex_set const & b) { return a &= b; }
+    friend hex_set operator-(hex_set a, hex_set const & b) { return a -= b; }
+    friend hex_set operator^(hex_set a, hex_set const & b) { return a ^= b; }
+
+    friend bool operator==(hex_set const &, hex_set const &) = default;
+
+    /** The packed rows, `row_words()` words per row. */
+    std::uint64_t const * data() const noexcept { return _words.data(); }
+
+    /** The number of words in each packed row. */
+    std::size_t row_words() const noexcept { return _stride; }
+
+    /** Iterates over the hexes of a set in row-major order. */
+    class iterator {
+    public:
+        using value_type = hex<int>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        hex<int> operator*() const noexcept
+        {
+            std::size_t const row = _word / _set->_stride;
+            std::size_t const column = (_word % _set->_stride) * 64
+                                     + std::countr_zero(_bits);
+            return _set->_origin + hex<int>{static_cast<int>(column),
+                                            static_cast<int>(row)};
+        }
+
+        iterator & operator++() noexcept
+        {
+            _bits &= _bits - 1;
+            skip_empty();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            auto const before = *this;
+            ++*this;
+            return before;
+        }
+
+        friend bool operator==(iterator const & a, iterator const & b) noexcept
+        {
+            return a._word == b._word and a._bits == b._bits;
+        }
+
+    private:
+        friend class hex_set;
+
+        hex_set const * _set = nullptr;
+        std::size_t _word = 0;
+        std::uint64_t _bits = 0;
+
+        iterator(hex_set const * set, std::size_t word) noexcept
+
+            : _set{set}, _word{word},
+              _bits{word < set->_words.size()? set->_words[word] : 0}
+        {
+            skip_empty();
+        }
+
+        void skip_empty() noexcept
+        {
+            auto const & words = _set->_words;
+            while (_bits == 0 and _word < words.size()) {
+                if (++_word < words.size()) {
+                    _bits = words[_word];
+                }
+            }
+        }
+    };
+
+    iterator begin() const noexcept { return iterator{this, 0}; }
+    iterator end() const noexcept { return iterator{this, _words.size()}; }
+
+private:
+    hex<int> _origin;
+    int _width;
+    int _height;
+    std::size_t _stride;
+    std::vector<std::uint64_t> _words;
+
+    std::pair<std::size_t, int> locate(hex<int> const & h) const noexcept
+    {
+        auto const q = static_cast<std::size_t>(h.q - _origin.q);
+        auto const r = static_cast<std::size_t>(h.r - _origin.r);
+        return {r*_stride + q/64, static_cast<int>(q % 64)};
+    }
+
+    template<typename Op>
+    void combine(hex_set const & other, Op op)
+    {
+        if (_origin != other._origin or _width != other._width
+                                     or _height != other._height) {
+            throw std::invalid_argument{"hex_sets must cover the same region"};
+        }
+        std::uint64_t * const into = _words.data();
+        std::uint64_t const * const from = other._words.data();
+        for (std::size_t i = 0; i < _words.size(); ++i) {
+            into[i] = op(into[i], from[i]);
+        }
+    }
+};
+}
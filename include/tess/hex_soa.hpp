@@ -0,0 +1,357 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <iterator>
+#include <vector>
+#include <span>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <stdexcept>
+#include <cstddef>
+
+#include "math.hpp"
+#include "hex.hpp"
+
+namespace tess {
+
+namespace detail {
+
+// allocates storage aligned to `Align` bytes
+template<typename T, std::size_t Align>
+struct aligned_allocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = aligned_allocator<U, Align>; };
+
+    aligned_allocator() noexcept = default;
+
+    template<typename U>
+    aligned_allocator(aligned_allocator<U, Align> const &) noexcept {}
+
+    T * allocate(std::size_t n)
+    {
+        return static_cast<T *>(
+            ::operator new(n * sizeof(T), std::align_val_t{Align}));
+    }
+
+    void deallocate(T * p, std::size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t{Align});
+    }
+
+    template<typename U>
+    bool operator==(aligned_allocator<U, Align> const &) const noexcept
+    {
+        return true;
+    }
+};
+}
+
+/**
+ * A buffer of hexes stored as two separate arrays, one of `q` components and
+ * one of `r` components.
+ *
+ * The bulk operations on a `hex_soa`, like adding an offset to every hex or
+ * finding every hex's norm, run one flat loop over each array, which the
+ * compiler can turn into vector instructions. A `std::vector<hex<Field>>`
+ * interleaves the components, which usually keeps the same loops scalar.
+ * Both arrays start on an `alignment` byte boundary.
+ *
+ * \code{.cpp}
+ * hex_soa<int> const units{positions};
+ * auto const distances = hex_distance(units, hex<int>{12, -4});
+ * \endcode
+ */
+template<numeric Field>
+class hex_soa {
+public:
+    using value_type = hex<Field>;
+
+    /** The byte boundary each array starts on. */
+    static constexpr std::size_t alignment = 64;
+
+    /** Create an empty buffer. */
+    hex_soa() = default;
+
+    /** Create a buffer of `count` copies of `value`. */
+    explicit hex_soa(std::size_t count, hex<Field> const & value = hex<Field>::zero)
+
+        : _q(count, value.q), _r(count, value.r)
+    {
+    }
+
+    /** Create a buffer of every hex in `hexes`. */
+    template<std::ranges::input_range Hexes>
+    requires std::convertible_to<std::ranges::range_reference_t<Hexes>,
+                                 hex<Field>>
+    explicit hex_soa(Hexes const & hexes)
+    {
+        if constexpr (std::ranges::sized_range<Hexes>) {
+            reserve(std::ranges::size(hexes));
+        }
+        for (hex<Field> const h : hexes) {
+            push_back(h);
+        }
+    }
+
+    /** The number of hexes in this buffer. */
+    std::size_t size() const noexcept { return _q.size(); }
+
+    /** Determine if this buffer has no hexes. */
+    bool empty() const noexcept { return _q.empty(); }
+
+    /** Make room for `count` hexes without reallocating. */
+    void reserve(std::size_t count)
+    {
+        _q.reserve(count);
+        _r.reserve(count);
+    }
+
+    /** Change the number of hexes to `count`, adding copies of `value`. */
+    void resize(std::size_t count, hex<Field> const & value = hex<Field>::zero)
+    {
+        _q.resize(count, value.q);
+        _r.resize(count, value.r);
+    }
+
+    /** Remove every hex from this buffer. */
+    void clear() noexcept
+    {
+        _q.clear();
+        _r.clear();
+    }
+
+    /** Add `h` to the end of this buffer. */
+    void push_back(hex<Field> const & h)
+    {
+        _q.push_back(h.q);
+        _r.push_back(h.r);
+    }
+
+    /** The hex at index `i`, which must be less than `size()`. */
+    hex<Field> operator[](std::size_t i) const noexcept
+    {
+        return hex<Field>{_q[i], _r[i]};
+    }
+
+    /** Set the hex at index `i`, which must be less than `size()`. */
+    void set(std::size_t i, hex<Field> const & h) noexcept
+    {
+        _q[i] = h.q;
+        _r[i] = h.r;
+    }
+
+    /** The `q` component of every hex. */
+    std::span<Field> q() noexcept { return _q; }
+
+    /** The `q` component of every hex. */
+    std::span<Field const> q() const noexcept { return _q; }
+
+    /** The `r` component of every hex. */
+    std::span<Field> r() noexcept { return _r; }
+
+    /** The `r` component of every hex. */
+    std::span<Field const> r() const noexcept { return _r; }
+
+    /** Write every hex of this buffer, in order. */
+    template<std::indirectly_writable<hex<Field>> Out>
+    requires std::weakly_incrementable<Out>
+    auto hexes(Out into_hexes) const
+    {
+        for (std::size_t i = 0; i < size(); ++i) {
+            *into_hexes++ = (*this)[i];
+        }
+        return into_hexes;
+    }
+
+    /** Add `offset` to every hex of this buffer. */
+    hex_soa & operator+=(hex<Field> const & offset) noexcept
+    {
+        shift(_q.data(), offset.q);
+        shift(_r.data(), offset.r);
+        return *this;
+    }
+
+    /** Subtract `offset` from every hex of this buffer. */
+    hex_soa & operator-=(hex<Field> const & offset) noexcept
+    {
+        return *this += -offset;
+    }
+
+    /**
+     * Add each hex of `other` to the hex at the same index of this buffer.
+     *
+     * \throws std::invalid_argument if the buffers have different sizes.
+     */
+    hex_soa & operator+=(hex_soa const & other)
+    {
+        check_size(other);
+        add(_q.data(), other._q.data());
+        add(_r.data(), other._r.data());
+        return *this;
+    }
+
+    /**
+     * Subtract each hex of `other` from the hex at the same index of this
+     * buffer.
+     *
+     * \throws std::invalid_argument if the buffers have different sizes.
+     */
+    hex_soa & operator-=(hex_soa const & other)
+    {
+        check_size(other);
+        subtract(_q.data(), other._q.data());
+        subtract(_r.data(), other._r.data());
+        return *this;
+    }
+
+    /** Determine if both buffers hold the same hexes in the same order. */
+    friend bool operator==(hex_soa const & a, hex_soa const & b)
+    {
+        return std::ranges::equal(a._q, b._q) and std::ranges::equal(a._r, b._r);
+    }
+
+private:
+    using array = std::vector<Field, detail::aligned_allocator<Field, alignment>>;
+    array _q;
+    array _r;
+
+    void check_size(hex_soa const & other) const
+    {
+        if (other.size() != size()) {
+            throw std::invalid_argument{"hex_soa sizes must match"};
+        }
+    }
+
+    // flat loops over aligned arrays, kept free of branches so they vectorize
+    void shift(Field * into, Field by) const noexcept
+    {
+        into = std::assume_aligned<alignment>(into);
+        std::size_t const n = size();
+        for (std::size_t i = 0; i < n; ++i) {
+            into[i] = static_cast<Field>(into[i] + by);
+        }
+    }
+
+    void add(Field * into, Field const * from) const noexcept
+    {
+        into = std::assume_aligned<alignment>(into);
+        from = std::assume_aligned<alignment>(from);
+        std::size_t const n = size();
+        for (std::size_t i = 0; i < n; ++i) {
+            into[i] = static_cast<Field>(into[i] + from[i]);
+        }
+    }
+
+    void subtract(Field * into, Field const * from) const noexcept
+    {
+        into = std::assume_aligned<alignment>(into);
+        from = std::assume_aligned<alignment>(from);
+        std::size_t const n = size();
+        for (std::size_t i = 0; i < n; ++i) {
+            into[i] = static_cast<Field>(into[i] - from[i]);
+        }
+    }
+};
+
+/**
+ * Add each hex of `a` to the hex at the same index of `b`.
+ *
+ * \throws std::invalid_argument if the buffers have different sizes.
+ */
+template<numeric Field>
+hex_soa<Field> operator+(hex_soa<Field> a, hex_soa<Field> const & b)
+{
+    return a += b;
+}
+
+/**
+ * Subtract each hex of `b` from the hex at the same index of `a`.
+ *
+ * \throws std::invalid_argument if the buffers have different sizes.
+ */
+template<numeric Field>
+hex_soa<Field> operator-(hex_soa<Field> a, hex_soa<Field> const & b)
+{
+    return a -= b;
+}
+
+/** Add `offset` to every hex of `hexes`. */
+template<numeric Field>
+hex_soa<Field> operator+(hex_soa<Field> hexes, hex<Field> const & offset)
+{
+    return hexes += offset;
+}
+
+/** Subtract `offset` from every hex of `hexes`. */
+template<numeric Field>
+hex_soa<Field> operator-(hex_soa<Field> hexes, hex<Field> const & offset)
+{
+    return hexes -= offset;
+}
+
+/**
+ * Calculate the distance from every hex of `hexes` to `to` into `distances`,
+ * so that `distances[i] == hex_norm(hexes[i] - to)`.
+ *
+ * \throws std::invalid_argument if `distances` has a different size than
+ *         `hexes`.
+ */
+template<numeric Field>
+void hex_distance(hex_soa<Field> const & hexes, hex<Field> const & to,
+                  std::span<Field> distances)
+{
+    if (distances.size() != hexes.size()) {
+        throw std::invalid_argument{
+            "hex_distance needs one distance for every hex"};
+    }
+    Field const * q = std::assume_aligned<hex_soa<Field>::alignment>(
+        hexes.q().data());
+    Field const * r = std::assume_aligned<hex_soa<Field>::alignment>(
+        hexes.r().data());
+    Field * into = distances.data();
+    for (std::size_t i = 0; i < distances.size(); ++i) {
+        Field const dq = static_cast<Field>(q[i] - to.q);
+        Field const dr = static_cast<Field>(r[i] - to.r);
+        Field const ds = static_cast<Field>(-dq - dr);
+        into[i] = static_cast<Field>(
+            (detail::abs(dq) + detail::abs(dr) + detail::abs(ds))/2);
+    }
+}
+
+/** Calculate the distance from every hex of `hexes` to `to`. */
+template<numeric Field>
+std::vector<Field> hex_distance(hex_soa<Field> const & hexes,
+                                hex<Field> const & to)
+{
+    std::vector<Field> distances(hexes.size());
+    hex_distance(hexes, to, std::span<Field>{distances});
+    return distances;
+}
+
+/**
+ * Calculate the norm of every hex of `hexes` into `norms`, so that
+ * `norms[i] == hex_norm(hexes[i])`.
+ *
+ * \throws std::invalid_argument if `norms` has a different size than
+ *         `hexes`.
+ */
+template<numeric Field>
+void hex_norm(hex_soa<Field> const & hexes, std::span<Field> norms)
+{
+    if (norms.size() != hexes.size()) {
+        throw std::invalid_argument{"hex_norm needs one norm for every hex"};
+    }
+    hex_distance(hexes, hex<Field>::zero, norms);
+}
+
+/** Calculate the norm of every hex of `hexes`. */
+template<numeric Field>
+std::vector<Field> hex_norm(hex_soa<Field> const & hexes)
+{
+    return hex_distance(hexes, hex<Field>::zero);
+}
+}
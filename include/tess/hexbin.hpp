@@ -0,0 +1,401 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <numeric>
+#include <span>
+#include <filesystem>
+#include <cstddef>
+
+#include "math.hpp"
+#include "hex.hpp"
+#include "basis.hpp"
+#include "grid.hpp"
+#include "parallel.hpp"
+#include "mapped_file.hpp"
+
+namespace tess {
+
+namespace detail {
+struct hexbin_access;
+}
+
+/** The aggregate of the weights of every point binned into a hex. */
+template<std::floating_point R>
+struct hexbin_cell {
+    std::size_t count = 0;
+    R sum = 0;
+    R min = std::numeric_limits<R>::infinity();
+    R max = -std::numeric_limits<R>::infinity();
+
+    /** Add a point with `weight` to this cell. */
+    void add(R weight) noexcept
+    {
+        ++count;
+        sum += weight;
+        min = std::min(min, weight);
+        max = std::max(max, weight);
+    }
+
+    /** Add every point of `other` to this cell. */
+    void merge(hexbin_cell const & other) noexcept
+    {
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+};
+
+/**
+ * Aggregates points in screen space by the hex they fall in.
+ *
+ * Bins cover a fixed `hex_grid` region. Points that round to a hex outside
+ * the region are only counted by `outside()`. Bulk adds split the points
+ * between threads, each accumulating into its own partial grid, and the
+ * partial grids are merged once every thread has finished. Every extra thread
+ * costs a pass over the whole region, so a thread is only used for every
+ * `minimum_points_per_thread` points, or for every cell of the region if
+ * there are more cells than that; smaller batches are binned serially.
+ *
+ * \code{.cpp}
+ * hexbin<float, HexTop::Pointed> heat{basis, hex<int>{-50, -50}, 100, 100};
+ * heat.add(positions);
+ * for (auto const & cell : heat.cells()) { ... }
+ * \endcode
+ */
+template<std::floating_point R, HexTop TopStyle>
+class hexbin {
+public:
+    /** The fewest points a bulk add gives to each thread it uses. */
+    static constexpr std::size_t minimum_points_per_thread = 4096;
+
+    /**
+     * Create empty bins over the `width` by `height` region at `origin`.
+     *
+     * \throws std::invalid_argument if `width` or `height` is negative.
+     */
+    hexbin(Basis<R, TopStyle> const & basis, hex<int> const & origin,
+           int width, int height)
+
+        : _basis{basis}, _cells{origin, width, height}, _outside{0}
+    {
+    }
+
+    /** The basis used to convert points to hexes. */
+    Basis<R, TopStyle> const & basis() const noexcept { return _basis; }
+
+    /** The aggregate of each hex in the region. */
+    hex_grid<hexbin_cell<R>> const & cells() const noexcept { return _cells; }
+
+    /** The number of points that fell outside of the region. */
+    std::size_t outside() const noexcept { return _outside; }
+
+    /** Add a single point with `weight`. */
+    template<cartesian Point>
+    void add(Point const & p, R weight = 1) noexcept
+    {
+        add_to(_cells, _outside, p, weight);
+    }
+
+    /** Add every point of `points`, each with a weight of one. */
+    template<std::ranges::random_access_range Points>
+    requires cartesian<std::ranges::range_value_t<Points>>
+    void add(Points const & points, unsigned threads = default_threads())
+    {
+        add_all(points, [](std::size_t) { return R(1); }, threads);
+    }
+
+    /**
+     * Add every point of `points`, weighted by the matching element of
+     * `weights`.
+     *
+     * \throws std::invalid_argument if there are fewer weights than points.
+     */
+    template<std::ranges::random_access_range Points,
+             std::ranges::random_access_range Weights>
+    requires cartesian<std::ranges::range_value_t<Points>>
+         and std::convertible_to<std::ranges::range_value_t<Weights>, R>
+    void add(Points const & points, Weights const & weights,
+             unsigned threads = default_threads())
+    {
+        if (std::ranges::size(weights) < std::ranges::size(points)) {
+            throw std::invalid_argument{"each point must have a weight"};
+        }
+        auto const first = std::ranges::begin(weights);
+        add_all(points, [first](std::size_t i) {
+            return static_cast<R>(first[i]);
+        }, threads);
+    }
+
+    /**
+     * Add every point binned by `other`.
+     *
+     * \throws std::invalid_argument if `other` covers a different region.
+     */
+    void merge(hexbin const & other)
+    {
+        if (not same_region(_cells, other._cells)) {
+            throw std::invalid_argument{"hexbins must cover the same region"};
+        }
+        merge_grids(_cells, {&other._cells}, 1);
+        _outside += other._outside;
+    }
+
+private:
+    friend struct detail::hexbin_access;
+
+    Basis<R, TopStyle> _basis;
+    hex_grid<hexbin_cell<R>> _cells;
+    std::size_t _outside;
+
+    template<cartesian Point>
+    void add_to(hex_grid<hexbin_cell<R>> & cells, std::size_t & outside,
+                Point const & p, R weight) const noexcept
+    {
+        auto const h = hex_round<int>(_basis.hex(p));
+        if (cells.contains(h)) {
+            cells[h].add(weight);
+        }
+        else {
+            ++outside;
+        }
+    }
+
+    // the partial grid of every band past the first, which accumulates
+    // straight into the result, and the points each band found outside
+    struct partial_bins {
+        std::vector<hex_grid<hexbin_cell<R>>> grids;
+        std::vector<std::size_t> outside;
+    };
+
+    template<typename Points, typename Weight>
+    void add_all(Points const & points, Weight && weight, unsigned threads)
+    {
+        auto const first = std::ranges::begin(points);
+        std::size_t const count = std::ranges::size(points);
+        std::size_t const bands = band_count(count, threads);
+        if (bands == 1) {
+            for (std::size_t i = 0; i < count; ++i) {
+                add_to(_cells, _outside, first[i], weight(i));
+            }
+            return;
+        }
+        auto partials = make_partials(bands);
+        add_all(points, weight, partials);
+        merge_partials(partials);
+    }
+
+    // split the points between the bands of `partials`, leaving them to be
+    // merged once the caller has added everything
+    template<typename Points, typename Weight>
+    void add_all(Points const & points, Weight && weight,
+                 partial_bins & partials)
+    {
+        auto const first = std::ranges::begin(points);
+        std::size_t const count = std::ranges::size(points);
+        auto const bands = static_cast<unsigned>(partials.outside.size());
+        parallel_for(count, bands,
+            [&](std::size_t band, std::size_t begin, std::size_t end) {
+                auto & cells = band == 0? _cells : partials.grids[band-1];
+                for (std::size_t i = begin; i < end; ++i) {
+                    add_to(cells, partials.outside[band], first[i],
+                           weight(i));
+                }
+            });
+    }
+
+    partial_bins make_partials(std::size_t bands) const
+    {
+        partial_bins partials;
+        partials.outside.assign(bands, 0);
+        for (std::size_t band = 1; band < bands; ++band) {
+            partials.grids.emplace_back(_cells.origin(), _cells.width(),
+                                        _cells.height());
+        }
+        return partials;
+    }
+
+    void merge_partials(partial_bins const & partials)
+    {
+        std::vector<hex_grid<hexbin_cell<R>> const *> sources;
+        for (auto const & grid : partials.grids) {
+            sources.push_back(&grid);
+        }
+        merge_grids(_cells, sources,
+                    static_cast<unsigned>(partials.outside.size()));
+        for (auto n : partials.outside) {
+            _outside += n;
+        }
+    }
+
+    // bin the records of every window of `file`, keeping the partial grids
+    // across windows so they're only allocated and merged once per file
+    template<typename Record>
+    void add_windows(mapped_file & file, std::size_t window, std::size_t total,
+                     unsigned threads)
+    {
+        auto partials = make_partials(band_count(total / sizeof(Record),
+                                                 threads));
+        auto const unit = [](std::size_t) { return R(1); };
+        for (std::size_t at = 0; at < total; at += window) {
+            auto const bytes = file.map(at, std::min(window, total - at));
+            std::span<Record const> const records{
+                reinterpret_cast<Record const *>(bytes.data()),
+                bytes.size() / sizeof(Record)
+            };
+            add_all(records, unit, partials);
+        }
+        merge_partials(partials);
+    }
+
+    // every band past the first allocates and merges a grid the size of the
+    // region, so only split when each band has enough points to pay for it
+    std::size_t band_count(std::size_t count, unsigned threads) const noexcept
+    {
+        std::size_t const per_band = std::max(minimum_points_per_thread,
+                                              _cells.size());
+        return std::clamp<std::size_t>(count / per_band, 1,
+                                       std::max(1u, threads));
+    }
+
+    static bool same_region(hex_grid<hexbin_cell<R>> const & a,
+                            hex_grid<hexbin_cell<R>> const & b) noexcept
+    {
+        return a.origin() == b.origin() and a.width() == b.width()
+           and a.height() == b.height();
+    }
+
+    // merge whole rows at a time, each thread owning a band of rows
+    static void merge_grids(
+        hex_grid<hexbin_cell<R>> & into,
+        std::vector<hex_grid<hexbin_cell<R>> const *> const & sources,
+        unsigned threads)
+    {
+        if (sources.empty()) {
+            return;
+        }
+        auto const rows = static_cast<std::size_t>(into.height());
+        parallel_for(rows, threads,
+            [&](std::size_t, std::size_t begin, std::size_t end) {
+                for (auto row = begin; row < end; ++row) {
+                    auto cells = into.row(static_cast<int>(row));
+                    for (auto const * source : sources) {
+                        auto const other = source->row(static_cast<int>(row));
+                        for (std::size_t q = 0; q < cells.size(); ++q) {
+                            cells[q].merge(other[q]);
+                        }
+                    }
+                }
+            });
+    }
+};
+
+namespace detail {
+// lets the streaming loaders below bin many windows before merging
+struct hexbin_access {
+    template<typename Record, std::floating_point R, HexTop TopStyle>
+    static void add_windows(hexbin<R, TopStyle> & bins, mapped_file & file,
+                            std::size_t window, std::size_t total,
+                            unsigned threads)
+    {
+        bins.template add_windows<Record>(file, window, total, threads);
+    }
+};
+}
+
+/**
+ * Bin every point of `points` into a region just large enough to hold them.
+ *
+ * Each point has a weight of one.
+ */
+template<std::floating_point R, HexTop TopStyle,
+         std::ranges::random_access_range Points>
+requires cartesian<std::ranges::range_value_t<Points>>
+hexbin<R, TopStyle> bin_points(Basis<R, TopStyle> const & basis,
+                               Points const & points,
+                               unsigned threads = default_threads())
+{
+    // find the bounds of the points in hex space, one band per thread
+    auto const first = std::ranges::begin(points);
+    std::size_t const count = std::ranges::size(points);
+    R constexpr inf = std::numeric_limits<R>::infinity();
+    struct bounds { R q0 = inf, q1 = -inf, r0 = inf, r1 = -inf; };
+    std::vector<bounds> found(std::max(1u, threads));
+
+    parallel_for(count, threads,
+        [&](std::size_t band, std::size_t begin, std::size_t end) {
+            auto & b = found[band];
+            for (std::size_t i = begin; i < end; ++i) {
+                auto const h = basis.hex(first[i]);
+                b.q0 = std::min(b.q0, h.q);
+                b.q1 = std::max(b.q1, h.q);
+                b.r0 = std::min(b.r0, h.r);
+                b.r1 = std::max(b.r1, h.r);
+            }
+        });
+
+    bounds total;
+    for (auto const & b : found) {
+        total.q0 = std::min(total.q0, b.q0);
+        total.q1 = std::max(total.q1, b.q1);
+        total.r0 = std::min(total.r0, b.r0);
+        total.r1 = std::max(total.r1, b.r1);
+    }
+    if (count == 0) {
+        return hexbin<R, TopStyle>{basis, hex<int>::zero, 0, 0};
+    }
+
+    // rounding moves a hex by less than one in each axial component
+    hex<int> const origin{static_cast<int>(std::floor(total.q0)) - 1,
+                          static_cast<int>(std::floor(total.r0)) - 1};
+    int const width = static_cast<int>(std::ceil(total.q1)) + 2 - origin.q;
+    int const height = static_cast<int>(std::ceil(total.r1)) + 2 - origin.r;
+
+    hexbin<R, TopStyle> bins{basis, origin, width, height};
+    bins.add(points, threads);
+    return bins;
+}
+
+/**
+ * Bin every point stored in the raw binary file at `path`.
+ *
+ * The file is a packed array of records, each holding the `x` then the `y`
+ * coordinate of a point as a `Scalar` in native byte order. The file is
+ * mapped `chunk_bytes` at a time and each chunk is binned before the next is
+ * mapped, so memory stays bounded by the chunk size and the size of the bins
+ * however large the file is. The partial grid of each thread is kept across
+ * chunks and merged once after the last chunk, with threads capped as for a
+ * bulk `hexbin::add` of every record in the file. Trailing bytes that don't
+ * make up a whole record are ignored.
+ *
+ * \code{.cpp}
+ * hexbin<double, HexTop::Flat> heat{basis, origin, width, height};
+ * bin_file<float>(heat, "positions.bin");
+ * \endcode
+ *
+ * \throws std::system_error if the file can't be opened or mapped.
+ */
+template<std::floating_point Scalar, std::floating_point R, HexTop TopStyle>
+void bin_file(hexbin<R, TopStyle> & bins, std::filesystem::path const & path,
+              std::size_t chunk_bytes = std::size_t{64} << 20,
+              unsigned threads = default_threads())
+{
+    struct record { Scalar x, y; };
+    mapped_file file{path};
+
+    // windows must start on a page boundary and hold whole records
+    std::size_t const step = std::lcm(mapped_file::page_size(),
+                                      sizeof(record));
+    std::size_t const window = std::max(step, chunk_bytes / step * step);
+    std::size_t const total = file.size() / sizeof(record) * sizeof(record);
+
+    detail::hexbin_access::add_windows<record>(bins, file, window, total,
+                                               threads);
+}
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <iterator>
+#include <functional>
+#include <unordered_map>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+#include "math.hpp"
+#include "hex.hpp"
+#include "grid.hpp"
+
+namespace tess {
+
+/**
+ * Calculate the hex one level coarser that contains `h`.
+ *
+ * Each coarse hex `p` groups the seven finer hexes within distance one of
+ * `hex_center_child(p)`, in the aperture-7 pattern. Coarse hexes form a hex
+ * tiling of their own, rotated and scaled by \f$\sqrt{7}\f$, so every level
+ * uses the same coordinates, directions and algorithms as the finest one.
+ *
+ * \code{.cpp}
+ * hex<int> const tile{12, -5};
+ * hex<int> const region = hex_parent(tile);
+ * assert(hex_norm(tile - hex_center_child(region)) <= 1);
+ * \endcode
+ */
+template<std::integral Integer>
+hex<Integer> hex_parent(hex<Integer> const & h) noexcept
+{
+    // invert the center child transform, then round to the nearest coarse
+    // hex; every finer hex is well within the rounding radius of its parent
+    double const q = static_cast<double>(3*h.q + h.r) / 7;
+    double const r = static_cast<double>(2*h.r - h.q) / 7;
+    return hex_round<Integer>(hex<double>{q, r});
+}
+
+/** Calculate the finer hex at the center of the coarse hex `p`. */
+template<std::integral Integer>
+hex<Integer> hex_center_child(hex<Integer> const & p) noexcept
+{
+    return hex<Integer>{static_cast<Integer>(2*p.q - p.r),
+                        static_cast<Integer>(p.q + 3*p.r)};
+}
+
+/**
+ * Calculate the seven finer hexes grouped by the coarse hex `p`.
+ *
+ * The center child is written first, followed by its neighbors in the order
+ * of `hex_directions`.
+ */
+template<std::integral Integer, std::indirectly_writable<hex<Integer>> Out>
+requires std::weakly_incrementable<Out>
+auto hex_children(hex<Integer> const & p, Out into_hexes)
+{
+    auto const center = hex_center_child(p);
+    *into_hexes++ = center;
+    for (auto const & d : hex_directions<Integer>) {
+        *into_hexes++ = center + d;
+    }
+    return into_hexes;
+}
+
+/** Calculate the hex `levels` levels coarser than `h` that contains it. */
+template<std::integral Integer>
+hex<Integer> hex_ancestor(hex<Integer> h, int levels) noexcept
+{
+    for (int i = 0; i < levels; ++i) {
+        h = hex_parent(h);
+    }
+    return h;
+}
+
+/**
+ * Calculate the hex `levels` levels finer than `p` at its center.
+ *
+ * This is the inverse of `hex_ancestor` for the center of each coarse hex.
+ */
+template<std::integral Integer>
+hex<Integer> hex_descendant(hex<Integer> p, int levels) noexcept
+{
+    for (int i = 0; i < levels; ++i) {
+        p = hex_center_child(p);
+    }
+    return p;
+}
+
+/**
+ * Combine the values of finer hexes into their parents.
+ *
+ * Each element of `values` is a pair-like `(hex, value)`. The values of every
+ * hex sharing a parent are folded together with `combine`, starting from the
+ * first one seen. Apply it repeatedly to climb more levels.
+ *
+ * \code{.cpp}
+ * std::unordered_map<hex<int>, int> population = ...;
+ * auto const regions = aggregate_parents(population, std::plus<>{});
+ * auto const provinces = aggregate_parents(regions, std::plus<>{});
+ * \endcode
+ */
+template<std::ranges::input_range Values, typename Combine = std::plus<>>
+auto aggregate_parents(Values const & values, Combine combine = {})
+{
+    using Element = std::ranges::range_value_t<Values>;
+    using Hex = std::remove_cvref_t<std::tuple_element_t<0, Element>>;
+    using Value = std::remove_cvref_t<std::tuple_element_t<1, Element>>;
+    std::unordered_map<Hex, Value> parents;
+    for (auto const & [h, value] : values) {
+        auto const [found, added] = parents.try_emplace(hex_parent(h), value);
+        if (not added) {
+            found->second = combine(found->second, value);
+        }
+    }
+    return parents;
+}
+
+/**
+ * Combine the tiles of `grid` into their parents.
+ *
+ * Every tile of the grid contributes, including those whose parent is only
+ * partially covered by the grid.
+ */
+template<typename T, typename Combine = std::plus<>>
+std::unordered_map<hex<int>, T>
+aggregate_parents(hex_grid<T> const & grid, Combine combine = {})
+{
+    std::unordered_map<hex<int>, T> parents;
+    for (std::size_t i = 0; i < grid.size(); ++i) {
+        auto const & value = grid.data()[i];
+        auto const parent = hex_parent(grid.hex_at(i));
+        auto const [found, added] = parents.try_emplace(parent, value);
+        if (not added) {
+            found->second = combine(found->second, value);
+        }
+    }
+    return parents;
+}
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <system_error>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <cstddef>
+#include <cerrno>
+
+#if __has_include(<sys/mman.h>) and __has_include(<unistd.h>)
+#define TESS_HAS_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <vector>
+#endif
+
+namespace tess {
+
+/**
+ * A read-only view of a file's bytes, one window at a time.
+ *
+ * Mapping a new window releases the previous one, so reading a file window by
+ * window keeps memory bounded no matter how large the file is. Where memory
+ * mapping isn't available, windows are read into a buffer instead.
+ *
+ * \code{.cpp}
+ * mapped_file file{"positions.bin"};
+ * for (std::size_t at = 0; at < file.size(); at += chunk) {
+ *     auto const bytes = file.map(at, chunk);
+ *     ...
+ * }
+ * \endcode
+ */
+class mapped_file {
+public:
+    /**
+     * Open the file at `path` for reading.
+     *
+     * \throws std::system_error if the file can't be opened.
+     */
+    explicit mapped_file(std::filesystem::path const & path)
+    {
+#ifdef TESS_HAS_MMAP
+        _fd = ::open(path.c_str(), O_RDONLY);
+        if (_fd < 0) {
+            throw std::system_error{errno, std::generic_category(),
+                                    "couldn't open " + path.string()};
+        }
+        struct stat info;
+        if (::fstat(_fd, &info) != 0) {
+            int const error = errno;
+            ::close(_fd);
+            throw std::system_error{error, std::generic_category(),
+                                    "couldn't stat " + path.string()};
+        }
+        _size = static_cast<std::size_t>(info.st_size);
+#else
+        _file.open(path, std::ios::binary);
+        if (not _file) {
+            throw std::system_error{
+                std::make_error_code(std::errc::no_such_file_or_directory),
+                "couldn't open " + path.string()};
+        }
+        _size = static_cast<std::size_t>(std::filesystem::file_size(path));
+#endif
+    }
+
+    mapped_file(mapped_file const &) = delete;
+    mapped_file & operator=(mapped_file const &) = delete;
+
+    mapped_file(mapped_file && other) noexcept { swap(other); }
+    mapped_file & operator=(mapped_file && other) noexcept
+    {
+        mapped_file moved{std::move(other)};
+        swap(moved);
+        return *this;
+    }
+
+    ~mapped_file()
+    {
+#ifdef TESS_HAS_MMAP
+        unmap();
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+#endif
+    }
+
+    /** The size of the file in bytes. */
+    std::size_t size() const noexcept { return _size; }
+
+    /** The granularity that window offsets must be a multiple of. */
+    static std::size_t page_size() noexcept
+    {
+#ifdef TESS_HAS_MMAP
+        return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#else
+        return 4096;
+#endif
+    }
+
+    /**
+     * View `length` bytes of the file starting at `offset`.
+     *
+     * The window is clamped to the end of the file. The returned bytes stay
+     * valid until the next call to `map` or until this file is destroyed.
+     *
+     * \throws std::invalid_argument if `offset` isn't a multiple of
+     *         `page_size()`.
+     * \throws std::system_error if the window can't be mapped.
+     */
+    std::span<std::byte const> map(std::size_t offset, std::size_t length)
+    {
+        if (offset % page_size() != 0) {
+            throw std::invalid_argument{
+                "window offset must be a multiple of the page size"};
+        }
+        length = offset < _size? std::min(length, _size - offset) : 0;
+#ifdef TESS_HAS_MMAP
+        unmap();
+        if (length == 0) {
+            return {};
+        }
+        void * const data = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE,
+                                   _fd, static_cast<off_t>(offset));
+        if (data == MAP_FAILED) {
+            throw std::system_error{errno, std::generic_category(),
+                                    "couldn't map file"};
+        }
+        ::madvise(data, length, MADV_SEQUENTIAL);
+        _window = static_cast<std::byte const *>(data);
+        _length = length;
+        return std::span<std::byte const>{_window, _length};
+#else
+        _buffer.resize(length);
+        _file.clear();
+        _file.seekg(static_cast<std::streamoff>(offset));
+        _file.read(reinterpret_cast<char *>(_buffer.data()),
+                   static_cast<std::streamsize>(length));
+        return std::span<std::byte const>{_buffer.data(), _buffer.size()};
+#endif
+    }
+
+    /** View every byte of the file at once. */
+    std::span<std::byte const> map() { return map(0, _size); }
+
+private:
+    std::size_t _size = 0;
+
+#ifdef TESS_HAS_MMAP
+    int _fd = -1;
+    std::byte const * _window = nullptr;
+    std::size_t _length = 0;
+
+    void unmap() noexcept
+    {
+        if (_window) {
+            ::munmap(const_cast<std::byte *>(_window), _length);
+            _window = nullptr;
+            _length = 0;
+        }
+    }
+
+    void swap(mapped_file & other) noexcept
+    {
+        std::swap(_size, other._size);
+        std::swap(_fd, other._fd);
+        std::swap(_window, other._window);
+        std::swap(_length, other._length);
+    }
+#else
+    std::ifstream _file;
+    std::vector<std::byte> _buffer;
+
+    void swap(mapped_file & other) noexcept
+    {
+        std::swap(_size, other._size);
+        std::swap(_file, other._file);
+        std::swap(_buffer, other._buffer);
+    }
+#endif
+};
+}
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <concepts>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "math.hpp"
+#include "hex.hpp"
+#include "basis.hpp"
+
+namespace tess {
+
+/** A range of bytes within a vertex buffer. */
+struct byte_span {
+    std::size_t offset;
+    std::size_t size;
+};
+
+/**
+ * A cache of vertex data for drawing a set of hex tiles.
+ *
+ * Every tile owns six consecutive vertices in `positions()` and `colors()`,
+ * calculated with `Basis::vertices`. The triangles of every tile are listed in
+ * `indices()`, which only grows or shrinks as tiles are added or removed.
+ *
+ * Changing a tile only rewrites that tile's vertices. The byte ranges that
+ * changed since the last call to `clear_dirty` are reported by
+ * `dirty_positions` and `dirty_colors`, so only those need to be uploaded to
+ * the renderer. Recoloring a tile only dirties its colors. The index buffer
+ * depends on nothing but `size()`, and `indices_resized` reports when it
+ * needs to be uploaded again.
+ *
+ * \code{.cpp}
+ * pointed_fmesh<sf::Vector2f, sf::Color> mesh{basis};
+ * mesh.insert(hex<int>::zero, sf::Color::White);
+ *
+ * // each frame
+ * mesh.set_color(hovered, sf::Color::Cyan);
+ * for (auto const & span : mesh.dirty_colors()) {
+ *     upload(color_buffer, span.offset, span.size);
+ * }
+ * mesh.clear_dirty();
+ * \endcode
+ */
+template<cartesian Point, typename Color,
+         std::floating_point R, HexTop TopStyle>
+class hex_mesh {
+public:
+    /** The number of vertices belonging to each tile. */
+    static constexpr std::size_t vertices_per_tile = 6;
+
+    /** The number of triangle indices belonging to each tile. */
+    static constexpr std::size_t indices_per_tile = 12;
+
+    /** Create an empty mesh whose vertices are calculated with `basis`. */
+    explicit hex_mesh(Basis<R, TopStyle> const & basis) : _basis{basis} {}
+
+    /** The number of tiles in this mesh. */
+    std::size_t size() const noexcept { return _tiles.size(); }
+
+    /** Determine if `h` is a tile of this mesh. */
+    bool contains(hex<int> const & h) const
+    {
+        return _slots.find(h) != _slots.end();
+    }
+
+    /**
+     * The index of the first vertex of `h`.
+     *
+     * \throws std::out_of_range if `h` isn't a tile of this mesh.
+     */
+    std::size_t first_vertex(hex<int> const & h) const
+    {
+        return slot(h) * vertices_per_tile;
+    }
+
+    /**
+     * Add `h` to this mesh with every vertex colored `color`.
+     *
+     * If `h` is already a tile of this mesh, only its color is changed.
+     */
+    void insert(hex<int> const & h, Color const & color)
+    {
+        auto const [mapping, added] = _slots.emplace(h, _tiles.size());
+        if (not added) {
+            set_color(h, color);
+            return;
+        }
+        _tiles.push_back(h);
+        _positions.resize(_positions.size() + vertices_per_tile);
+        _colors.resize(_colors.size() + vertices_per_tile);
+        _dirty_positions.push_back();
+        _dirty_colors.push_back();
+
+        std::size_t const i = mapping->second;
+        auto const first = static_cast<std::uint32_t>(i * vertices_per_tile);
+        for (std::uint32_t k = 1; k < 5; ++k) {
+            _indices.insert(_indices.end(), {first, first + k, first + k+1});
+        }
+        write(i, color);
+    }
+
+    /**
+     * Remove `h` from this mesh.
+     *
+     * The last tile is moved into the slot `h` occupied, so the vertex
+     * buffers stay contiguous. Returns `false` if `h` wasn't a tile of this
+     * mesh.
+     */
+    bool erase(hex<int> const & h)
+    {
+        auto const found = _slots.find(h);
+        if (found == _slots.end()) {
+            return false;
+        }
+        std::size_t const i = found->second;
+        std::size_t const last = _tiles.size() - 1;
+        _slots.erase(found);
+
+        if (i != last) {
+            hex<int> const moved = _tiles[last];
+            _tiles[i] = moved;
+            _slots[moved] = i;
+            std::copy_n(_positions.begin() + last*vertices_per_tile,
+                        vertices_per_tile,
+                        _positions.begin() + i*vertices_per_tile);
+            std::copy_n(_colors.begin() + last*vertices_per_tile,
+                        vertices_per_tile,
+                        _colors.begin() + i*vertices_per_tile);
+            _dirty_positions.mark(i);
+            _dirty_colors.mark(i);
+        }
+        _tiles.pop_back();
+        _positions.resize(last * vertices_per_tile);
+        _colors.resize(last * vertices_per_tile);
+        _indices.resize(last * indices_per_tile);
+        _dirty_positions.pop_back();
+        _dirty_colors.pop_back();
+        return true;
+    }
+
+    /**
+     * Color every vertex of `h` with `color`.
+     *
+     * \throws std::out_of_range if `h` isn't a tile of this mesh.
+     */
+    void set_color(hex<int> const & h, Color const & color)
+    {
+        std::size_t const i = slot(h);
+        auto const first = _colors.begin() + i*vertices_per_tile;
+        std::fill_n(first, vertices_per_tile, color);
+        _dirty_colors.mark(i);
+    }
+
+    /** The vertex positions of every tile. */
+    std::vector<Point> const & positions() const noexcept
+    {
+        return _positions;
+    }
+
+    /** The vertex colors of every tile. */
+    std::vector<Color> const & colors() const noexcept { return _colors; }
+
+    /** The triangle indices of every tile into the vertex buffers. */
+    std::vector<std::uint32_t> const & indices() const noexcept
+    {
+        return _indices;
+    }
+
+    /** The byte ranges of `positions()` changed since the last clear. */
+    std::vector<byte_span> dirty_positions() const
+    {
+        return _dirty_positions.spans(vertices_per_tile * sizeof(Point));
+    }
+
+    /** The byte ranges of `colors()` changed since the last clear. */
+    std::vector<byte_span> dirty_colors() const
+    {
+        return _dirty_colors.spans(vertices_per_tile * sizeof(Color));
+    }
+
+    /**
+     * Determine if `indices()` changed size since the last clear.
+     *
+     * The indices of a tile only depend on its slot, so the index buffer only
+     * needs to be uploaded again when this is true.
+     */
+    bool indices_resized() const noexcept
+    {
+        return _indices.size() != _clean_indices;
+    }
+
+    /** Mark every tile of this mesh as up to date. */
+    void clear_dirty() noexcept
+    {
+        _dirty_positions.clear();
+        _dirty_colors.clear();
+        _clean_indices = _indices.size();
+    }
+
+private:
+    Basis<R, TopStyle> _basis;
+    std::unordered_map<hex<int>, std::size_t> _slots;
+    std::vector<hex<int>> _tiles;
+
+    std::vector<Point> _positions;
+    std::vector<Color> _colors;
+    std::vector<std::uint32_t> _indices;
+
+    // the slots of one vertex buffer changed since the last clear, and a
+    // flag for each slot so that a slot is only listed once
+    class dirty_slots {
+    public:
+        void push_back() { _dirty.push_back(false); }
+        void pop_back() { _dirty.pop_back(); }
+
+        void mark(std::size_t i)
+        {
+            if (not _dirty[i]) {
+                _dirty[i] = true;
+                _changed.push_back(i);
+            }
+        }
+
+        void clear() noexcept
+        {
+            for (auto i : _changed) {
+                if (i < _dirty.size()) {
+                    _dirty[i] = false;
+                }
+            }
+            _changed.clear();
+        }
+
+        std::vector<byte_span> spans(std::size_t tile_bytes) const
+        {
+            std::vector<std::size_t> slots;
+            slots.reserve(_changed.size());
+            std::copy_if(_changed.begin(), _changed.end(),
+                         std::back_inserter(slots),
+                         [this](std::size_t i) { return i < _dirty.size(); });
+            std::sort(slots.begin(), slots.end());
+            slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+
+            // merge runs of consecutive slots into a single span
+            std::vector<byte_span> spans;
+            for (auto i : slots) {
+                if (not spans.empty() and
+                        spans.back().offset + spans.back().size
+                            == i*tile_bytes) {
+                    spans.back().size += tile_bytes;
+                }
+                else {
+                    spans.push_back(byte_span{i*tile_bytes, tile_bytes});
+                }
+            }
+            return spans;
+        }
+
+    private:
+        std::vector<std::size_t> _changed;
+        std::vector<bool> _dirty;
+    };
+
+    dirty_slots _dirty_positions;
+    dirty_slots _dirty_colors;
+    std::size_t _clean_indices = 0;
+
+    std::size_t slot(hex<int> const & h) const
+    {
+        auto const found = _slots.find(h);
+        if (found == _slots.end()) {
+            throw std::out_of_range{"hex isn't a tile of the mesh"};
+        }
+        return found->second;
+    }
+
+    void write(std::size_t i, Color const & color)
+    {
+        auto const first = i*vertices_per_tile;
+        _basis.template vertices<Point>(_tiles[i], _positions.begin() + first);
+        std::fill_n(_colors.begin() + first, vertices_per_tile, color);
+        _dirty_positions.mark(i);
+        _dirty_colors.mark(i);
+    }
+};
+
+template<cartesian Point, typename Color>
+using flat_fmesh = hex_mesh<Point, Color, float, HexTop::Flat>;
+
+template<cartesian Point, typename Color>
+using pointed_fmesh = hex_mesh<Point, Color, float, HexTop::Pointed>;
+}
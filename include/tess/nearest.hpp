@@ -0,0 +1,257 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <iterator>
+#include <vector>
+#include <span>
+#include <unordered_map>
+#include <numeric>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+
+#include "hex.hpp"
+#include "hex_soa.hpp"
+#include "parallel.hpp"
+
+namespace tess {
+
+/**
+ * Calculate the distance from every hex of `queries` to every hex of
+ * `targets` into `distances`, one row of targets per query.
+ *
+ * Afterwards, `distances[i * targets.size() + j]` is the distance from
+ * `queries[i]` to `targets[j]`. Each row is one `hex_distance` over the
+ * targets, and rows are split between `threads` threads.
+ *
+ * \throws std::invalid_argument if `distances` doesn't hold exactly one
+ *         distance for every pair.
+ */
+template<numeric Field>
+void hex_distances(hex_soa<Field> const & queries,
+                   hex_soa<Field> const & targets, std::span<Field> distances,
+                   unsigned threads = default_threads())
+{
+    std::size_t const row = targets.size();
+    if (distances.size() != queries.size() * row) {
+        throw std::invalid_argument{
+            "hex_distances needs one distance for every pair"};
+    }
+    parallel_for(queries.size(), threads,
+                 [&](std::size_t, std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            hex_distance(targets, queries[i], distances.subspan(i * row, row));
+        }
+    });
+}
+
+namespace detail {
+
+// spreads neighboring tiles over the whole table, unlike std::hash<hex>
+struct tile_hash {
+    std::size_t operator()(hex<int> const & h) const noexcept
+    {
+        std::uint64_t const mixed = mix(h);
+        return static_cast<std::size_t>(mixed ^ (mixed >> 32));
+    }
+};
+
+// an output iterator that hands every hex written to it to `visit`
+template<typename Visit>
+class visit_iterator {
+public:
+    using difference_type = std::ptrdiff_t;
+
+    struct proxy {
+        Visit * visit;
+        proxy const & operator=(hex<int> const & h) const
+        {
+            (*visit)(h);
+            return *this;
+        }
+    };
+
+    explicit visit_iterator(Visit & visit) noexcept : _visit{&visit} {}
+
+    proxy operator*() const noexcept { return proxy{_visit}; }
+    visit_iterator & operator++() noexcept { return *this; }
+    visit_iterator operator++(int) noexcept { return *this; }
+
+private:
+    Visit * _visit;
+};
+}
+
+/**
+ * An index of target hexes for finding the targets nearest to a hex.
+ *
+ * Targets are grouped by the tile they're on, and a search looks at the
+ * rings around the query one after another, closest first, until it has
+ * found enough targets. Every target on a ring is the same distance from the
+ * query, so the targets found are exactly the nearest, and a search only
+ * looks at the tiles around the query rather than at every target. When
+ * targets are so sparse that the rings would cover more tiles than there are
+ * targets, the search measures the distance to every target instead.
+ *
+ * Several targets may share a tile. Targets are referred to by their index in
+ * the range the index was made from.
+ *
+ * \code{.cpp}
+ * nearest_index const ore{deposit_tiles};
+ * std::vector<std::size_t> choices;
+ * ore.nearest(miner.tile, 3, std::back_inserter(choices));
+ * \endcode
+ */
+class nearest_index {
+public:
+    /** The index of a target that wasn't found. */
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /** Create an index of every hex in `targets`. */
+    template<std::ranges::input_range Targets>
+    requires std::convertible_to<std::ranges::range_reference_t<Targets>,
+                                 hex<int>>
+    explicit nearest_index(Targets const & targets)
+
+        : _targets{targets}
+    {
+        _order.resize(_targets.size());
+        std::iota(_order.begin(), _order.end(), std::size_t{0});
+        auto const row_major = [this](std::size_t a, std::size_t b) {
+            auto const ha = _targets[a];
+            auto const hb = _targets[b];
+            return std::tie(ha.r, ha.q, a) < std::tie(hb.r, hb.q, b);
+        };
+        std::ranges::sort(_order, row_major);
+        for (std::size_t i = 0; i < _order.size(); ) {
+            auto const h = _targets[_order[i]];
+            std::size_t last = i + 1;
+            while (last < _order.size() and _targets[_order[last]] == h) {
+                ++last;
+            }
+            _tiles.emplace(h, std::pair{i, last});
+            i = last;
+        }
+    }
+
+    /** The number of targets. */
+    std::size_t size() const noexcept { return _targets.size(); }
+
+    /** The tile of target `i`, which must be less than `size()`. */
+    hex<int> operator[](std::size_t i) const noexcept { return _targets[i]; }
+
+    /** Every target, in the order the index was made from. */
+    hex_soa<int> const & targets() const noexcept { return _targets; }
+
+    /** The targets on tile `h`. */
+    std::span<std::size_t const> at(hex<int> const & h) const noexcept
+    {
+        auto const found = _tiles.find(h);
+        if (found == _tiles.end()) {
+            return {};
+        }
+        auto const [first, last] = found->second;
+        return std::span{_order}.subspan(first, last - first);
+    }
+
+    /**
+     * Find the `k` targets nearest to `from`, and write their indices nearest
+     * first.
+     *
+     * Fewer than `k` are written if there aren't that many targets. Targets
+     * the same distance away are written in no particular order.
+     */
+    template<std::indirectly_writable<std::size_t> Out>
+    requires std::weakly_incrementable<Out>
+    auto nearest(hex<int> const & from, std::size_t k, Out into_targets) const
+    {
+        std::vector<std::size_t> found;
+        std::vector<int> distances;
+        search(from, k, found, distances);
+        return std::ranges::copy(found, into_targets).out;
+    }
+
+    /**
+     * Find the `k` targets nearest to each of `from`, on `threads` threads.
+     *
+     * The indices of the targets nearest to `from[i]` are written nearest
+     * first to `into[i*k]` through `into[i*k + k - 1]`, followed by `npos`
+     * if there are fewer than `k` targets.
+     *
+     * \throws std::invalid_argument if `into` doesn't hold exactly `k`
+     *         indices for each of `from`.
+     */
+    void nearest(std::span<hex<int> const> from, std::size_t k,
+                 std::span<std::size_t> into,
+                 unsigned threads = default_threads()) const
+    {
+        if (into.size() != from.size() * k) {
+            throw std::invalid_argument{
+                "nearest needs room for k targets of every hex"};
+        }
+        parallel_for(from.size(), threads,
+                     [&](std::size_t, std::size_t first, std::size_t last) {
+            std::vector<std::size_t> found;
+            std::vector<int> distances;
+            for (std::size_t i = first; i < last; ++i) {
+                search(from[i], k, found, distances);
+                auto const out = into.subspan(i * k, k);
+                std::ranges::fill(std::ranges::copy(found, out.begin()).out,
+                                  out.end(), npos);
+            }
+        });
+    }
+
+private:
+    hex_soa<int> _targets;
+    std::vector<std::size_t> _order;
+    std::unordered_map<hex<int>, std::pair<std::size_t, std::size_t>,
+                       detail::tile_hash> _tiles;
+
+    void search(hex<int> const & from, std::size_t k,
+                std::vector<std::size_t> & found,
+                std::vector<int> & distances) const
+    {
+        found.clear();
+        k = std::min(k, size());
+        if (k == 0) {
+            return;
+        }
+
+        auto const visit = [&](hex<int> const & h) {
+            for (auto const i : at(h)) {
+                found.push_back(i);
+            }
+        };
+        std::size_t covered = 0;
+        for (int r = 0; found.size() < k; ++r) {
+            covered += hex_ring_size(r);
+            if (covered > size()) {
+                return scan(from, k, found, distances);
+            }
+            hex_ring(from, r, detail::visit_iterator{visit});
+        }
+        found.resize(k);
+    }
+
+    // measure the distance to every target and keep the nearest
+    void scan(hex<int> const & from, std::size_t k,
+              std::vector<std::size_t> & found,
+              std::vector<int> & distances) const
+    {
+        distances.resize(size());
+        hex_distance(_targets, from, std::span<int>{distances});
+        found.resize(size());
+        std::iota(found.begin(), found.end(), std::size_t{0});
+        auto const closer = [&distances](std::size_t a, std::size_t b) {
+            return std::tie(distances[a], a) < std::tie(distances[b], b);
+        };
+        std::ranges::partial_sort(found, found.begin() + k, closer);
+        found.resize(k);
+    }
+};
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <concepts>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+
+#include "hex.hpp"
+#include "point.hpp"
+#include "basis.hpp"
+#include "grid.hpp"
+#include "parallel.hpp"
+
+namespace tess {
+
+/**
+ * Two dimensional simplex noise.
+ *
+ * Noise is a smooth, seeded pseudo-random function of the plane that varies
+ * over a distance of about one unit and stays within `[-1, 1]`. Noise with
+ * the same seed always gives the same value at the same point, so tiles can
+ * be generated chunk by chunk and still join up seamlessly.
+ *
+ * Gradients are picked by hashing the lattice corners rather than by looking
+ * them up in a permutation table, and the sampling loops are free of
+ * branches, so sampling many points at once can be vectorized by the
+ * compiler.
+ *
+ * \code{.cpp}
+ * simplex_noise const noise{world_seed};
+ * hex_grid<float> height{chunk_origin, 64, 64};
+ * fill_noise(height, basis, noise, 1/200.f, 5);
+ * \endcode
+ */
+class simplex_noise {
+public:
+    /** Create the noise of `seed`. */
+    explicit simplex_noise(std::uint32_t seed = 0) noexcept : _seed{seed} {}
+
+    /** The seed of this noise. */
+    std::uint32_t seed() const noexcept { return _seed; }
+
+    /** Sample the noise at `(x, y)`. */
+    template<std::floating_point R>
+    R operator()(R x, R y) const noexcept
+    {
+        return std::clamp(corners(x, y), R(-1), R(1));
+    }
+
+    /** Sample the noise at `p`. */
+    template<std::floating_point R>
+    R operator()(point<R> const & p) const noexcept
+    {
+        return (*this)(p.x, p.y);
+    }
+
+    /**
+     * Sample the noise at `(xs[i], ys[i])` into `into[i]` for every `i`.
+     *
+     * \throws std::invalid_argument if the spans have different sizes.
+     */
+    template<std::floating_point R>
+    void operator()(std::span<R const> xs, std::span<R const> ys,
+                    std::span<R> into) const
+    {
+        if (ys.size() != xs.size() or into.size() != xs.size()) {
+            throw std::invalid_argument{
+                "noise needs one x, one y and one value for every sample"};
+        }
+        for (std::size_t k = 0; k < into.size(); ++k) {
+            into[k] = corners(xs[k], ys[k]);
+        }
+        clamp(into);
+    }
+
+    /**
+     * Sample the noise at the evenly spaced points `start + i*step` into
+     * `into[i]` for every `i`.
+     *
+     * This is the quickest way to sample a row of tiles, since the points are
+     * calculated as they're sampled rather than read from memory.
+     */
+    template<std::floating_point R>
+    void operator()(point<R> const & start, point<R> const & step,
+                    std::span<R> into) const noexcept
+    {
+        // 32-bit counters convert to R within vector registers, so points are
+        // counted from the start of blocks short enough for one
+        std::size_t constexpr block = std::size_t{1} << 30;
+        for (std::size_t first = 0; first < into.size(); first += block) {
+            auto const n = static_cast<std::int32_t>(
+                std::min(block, into.size() - first));
+            R const x = start.x + static_cast<R>(first) * step.x;
+            R const y = start.y + static_cast<R>(first) * step.y;
+            R * const values = into.data() + first;
+            for (std::int32_t k = 0; k < n; ++k) {
+                R const i = static_cast<R>(k);
+                values[k] = corners(x + i*step.x, y + i*step.y);
+            }
+        }
+        clamp(into);
+    }
+
+private:
+    std::uint32_t _seed;
+
+    std::uint32_t hash(std::int32_t i, std::int32_t j) const noexcept
+    {
+        std::uint32_t h = static_cast<std::uint32_t>(i) * 0x27d4eb2du
+                        ^ static_cast<std::uint32_t>(j) * 0x165667b1u
+                        ^ _seed * 0x9e3779b9u;
+        h ^= h >> 15;
+        h *= 0x2c1b3c6du;
+        h ^= h >> 12;
+        return h;
+    }
+
+    // one of eight gradients, dotted with (x, y), picked with arithmetic
+    // rather than branches
+    template<std::floating_point R>
+    static R gradient(std::uint32_t h, R x, R y) noexcept
+    {
+        R const swap = static_cast<R>((h >> 2) & 1);
+        R const u = x + (y - x) * swap;
+        R const v = y + (x - y) * swap;
+        R const su = R(1) - R(2) * static_cast<R>(h & 1);
+        R const sv = R(2) - R(4) * static_cast<R>((h >> 1) & 1);
+        return su*u + sv*v;
+    }
+
+    template<std::floating_point R>
+    static R falloff(R x, R y) noexcept
+    {
+        // max(t, 0) without a comparison, which would keep the loop scalar
+        R const t = R(0.5) - x*x - y*y;
+        R const positive = (t + std::abs(t)) / 2;
+        return (positive*positive) * (positive*positive);
+    }
+
+    template<std::floating_point R>
+    static std::int32_t floor(R x) noexcept
+    {
+        auto const i = static_cast<std::int32_t>(x);
+        return i - static_cast<std::int32_t>(x < static_cast<R>(i));
+    }
+
+    template<std::floating_point R>
+    static void clamp(std::span<R> values) noexcept
+    {
+        for (auto & value : values) {
+            value = std::clamp(value, R(-1), R(1));
+        }
+    }
+
+    // the noise at (x, y) before clamping: skew onto the lattice of
+    // triangles, find the triangle holding the point, then add up the
+    // contributions of its three corners
+    template<std::floating_point R>
+    R corners(R x, R y) const noexcept
+    {
+        R constexpr skew = R(0.36602540378443864676);    // (sqrt(3) - 1)/2
+        R constexpr unskew = R(0.21132486540518711775);  // (3 - sqrt(3))/6
+        R const s = (x + y) * skew;
+        std::int32_t const i = floor(x + s);
+        std::int32_t const j = floor(y + s);
+        R const t = static_cast<R>(i + j) * unskew;
+        R const x0 = x - (static_cast<R>(i) - t);
+        R const y0 = y - (static_cast<R>(j) - t);
+
+        auto const i1 = static_cast<std::int32_t>(x0 > y0);
+        std::int32_t const j1 = 1 - i1;
+        R const x1 = x0 - static_cast<R>(i1) + unskew;
+        R const y1 = y0 - static_cast<R>(j1) + unskew;
+        R const x2 = x0 - 1 + 2*unskew;
+        R const y2 = y0 - 1 + 2*unskew;
+
+        R const n0 = falloff(x0, y0) * gradient(hash(i, j), x0, y0);
+        R const n1 = falloff(x1, y1) * gradient(hash(i + i1, j + j1), x1, y1);
+        R const n2 = falloff(x2, y2) * gradient(hash(i + 1, j + 1), x2, y2);
+        return R(40) * (n0 + n1 + n2);
+    }
+};
+
+/**
+ * Fill every tile of `into` with fractal noise sampled at the exact screen
+ * space center of the tile in `basis`, on `threads` threads.
+ *
+ * The noise is the sum of `octaves` layers of `noise`. The first is sampled
+ * at `frequency` times the screen position, and each further layer at twice
+ * the frequency of the one before with half its weight. The sum is divided
+ * by the total weight, so every tile is in `[-1, 1]`. Tiles are sampled a row
+ * at a time, and rows are split between the threads.
+ *
+ * Since tiles are sampled at their absolute position, grids filled
+ * separately with the same noise line up with each other.
+ *
+ * \throws std::invalid_argument if `octaves` isn't positive.
+ */
+template<std::floating_point R, HexTop TopStyle>
+void fill_noise(hex_grid<R> & into, Basis<R, TopStyle> const & basis,
+                simplex_noise const & noise, R frequency = R(1),
+                int octaves = 1, unsigned threads = default_threads())
+{
+    if (octaves <= 0) {
+        throw std::invalid_argument{"noise needs at least one octave"};
+    }
+    int const width = into.width();
+
+    // positions are linear in q and r, so each row is a start and a step
+    auto const zero = basis.position(hex<int>::zero);
+    auto const start = basis.position(into.origin());
+    auto const along = basis.position(hex<int>{1, 0}) - zero;
+    auto const down = basis.position(hex<int>{0, 1}) - zero;
+
+    parallel_for(static_cast<std::size_t>(into.height()), threads,
+                 [&](std::size_t, std::size_t first, std::size_t last) {
+        std::size_t const n = static_cast<std::size_t>(width);
+        std::vector<R> layer(n);
+        for (std::size_t r = first; r < last; ++r) {
+            std::span<R> const row{into.data() + r * n, n};
+            point<R> const row_start{start.x + down.x * static_cast<R>(r),
+                                     start.y + down.y * static_cast<R>(r)};
+            std::ranges::fill(row, R(0));
+            R scale = frequency;
+            R weight = 1;
+            R total = 0;
+            for (int octave = 0; octave < octaves; ++octave) {
+                noise(point<R>{row_start.x * scale, row_start.y * scale},
+                      point<R>{along.x * scale, along.y * scale},
+                      std::span<R>{layer});
+                for (std::size_t q = 0; q < n; ++q) {
+                    row[q] += weight * layer[q];
+                }
+                total += weight;
+                scale *= 2;
+                weight /= 2;
+            }
+            for (auto & value : row) {
+                value /= total;
+            }
+        }
+    });
+}
+}
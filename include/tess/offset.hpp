@@ -0,0 +1,192 @@
+#pragma once
+
+#include <concepts>
+#include <iterator>
+#include <vector>
+#include <cstddef>
+
+#include "math.hpp"
+#include "hex.hpp"
+
+namespace tess {
+
+/**
+ * The layouts of offset coordinates.
+ *
+ * `OddR` and `EvenR` shift every odd or even row half a tile to the right,
+ * and suit pointed-top hexes. `OddQ` and `EvenQ` shift every odd or even
+ * column half a tile down, and suit flat-top hexes.
+ */
+enum class OffsetStyle { OddR, EvenR, OddQ, EvenQ };
+
+/**
+ * A hex coordinate given as a column and row of a rectangular map.
+ *
+ * \code{.cpp}
+ * odd_r<int> const tile{3, 5};
+ * hex<int> const h = to_axial(tile);
+ * assert(to_offset<OffsetStyle::OddR>(h) == tile);
+ * \endcode
+ */
+template<std::integral Integer, OffsetStyle Style>
+struct offset {
+    Integer col, row;
+};
+
+template<std::integral Integer>
+using odd_r = offset<Integer, OffsetStyle::OddR>;
+template<std::integral Integer>
+using even_r = offset<Integer, OffsetStyle::EvenR>;
+template<std::integral Integer>
+using odd_q = offset<Integer, OffsetStyle::OddQ>;
+template<std::integral Integer>
+using even_q = offset<Integer, OffsetStyle::EvenQ>;
+
+template<std::integral Integer, OffsetStyle Style>
+bool operator==(offset<Integer, Style> const & a,
+                offset<Integer, Style> const & b)
+{
+    return a.col == b.col and a.row == b.row;
+}
+
+/**
+ * How far the axial coordinate of a line is shifted from its offset
+ * coordinate, where `line` is the row for row layouts or the column for
+ * column layouts.
+ */
+template<OffsetStyle Style, std::integral Integer>
+Integer offset_shift(Integer line) noexcept
+{
+    if constexpr (Style == OffsetStyle::OddR or Style == OffsetStyle::OddQ) {
+        return (line - (line & 1)) / 2;
+    }
+    else {
+        return (line + (line & 1)) / 2;
+    }
+}
+
+/** Convert `o` to axial coordinates. */
+template<std::integral Integer, OffsetStyle Style>
+hex<Integer> to_axial(offset<Integer, Style> const & o) noexcept
+{
+    if constexpr (Style == OffsetStyle::OddR or Style == OffsetStyle::EvenR) {
+        return hex<Integer>{
+            static_cast<Integer>(o.col - offset_shift<Style>(o.row)), o.row
+        };
+    }
+    else {
+        return hex<Integer>{
+            o.col, static_cast<Integer>(o.row - offset_shift<Style>(o.col))
+        };
+    }
+}
+
+/** Convert `h` to offset coordinates in the `Style` layout. */
+template<OffsetStyle Style, std::integral Integer>
+offset<Integer, Style> to_offset(hex<Integer> const & h) noexcept
+{
+    if constexpr (Style == OffsetStyle::OddR or Style == OffsetStyle::EvenR) {
+        return offset<Integer, Style>{
+            static_cast<Integer>(h.q + offset_shift<Style>(h.r)), h.r
+        };
+    }
+    else {
+        return offset<Integer, Style>{
+            h.q, static_cast<Integer>(h.r + offset_shift<Style>(h.q))
+        };
+    }
+}
+
+/**
+ * Calculate the axial coordinates of every tile of a row-major offset map.
+ *
+ * The map has `width` columns and `height` rows, starting at column and row
+ * zero. Hexes are written in the same order as the tiles of the map, so the
+ * `i`th hex belongs to the `i`th element of a row-major array.
+ *
+ * For row layouts the shift is constant across a row, so each row is a plain
+ * run of consecutive `q`. For column layouts the shift of each column is
+ * calculated once and reused for every row.
+ *
+ * \code{.cpp}
+ * std::vector<terrain> const tiles = load_map(width, height);
+ * std::vector<hex<int>> hexes;
+ * offset_map_to_axial<OffsetStyle::OddR>(width, height,
+ *                                        std::back_inserter(hexes));
+ * \endcode
+ */
+template<OffsetStyle Style, std::integral Integer,
+         std::indirectly_writable<hex<Integer>> Out>
+requires std::weakly_incrementable<Out>
+auto offset_map_to_axial(Integer width, Integer height, Out into_hexes)
+{
+    if constexpr (Style == OffsetStyle::OddR or Style == OffsetStyle::EvenR) {
+        for (Integer row = 0; row < height; ++row) {
+            Integer const q0 = -offset_shift<Style>(row);
+            for (Integer col = 0; col < width; ++col) {
+                *into_hexes++ = hex<Integer>{
+                    static_cast<Integer>(q0 + col), row
+                };
+            }
+        }
+    }
+    else {
+        std::vector<Integer> shifts(static_cast<std::size_t>(width));
+        for (Integer col = 0; col < width; ++col) {
+            shifts[col] = offset_shift<Style>(col);
+        }
+        for (Integer row = 0; row < height; ++row) {
+            for (Integer col = 0; col < width; ++col) {
+                *into_hexes++ = hex<Integer>{
+                    col, static_cast<Integer>(row - shifts[col])
+                };
+            }
+        }
+    }
+    return into_hexes;
+}
+
+/**
+ * Convert a row of offset coordinates to axial coordinates.
+ *
+ * The row has `count` tiles starting at `first_col`. Writes `count` hexes.
+ */
+template<OffsetStyle Style, std::integral Integer,
+         std::indirectly_writable<hex<Integer>> Out>
+requires std::weakly_incrementable<Out>
+auto offset_row_to_axial(Integer row, Integer first_col, Integer count,
+                         Out into_hexes)
+{
+    if constexpr (Style == OffsetStyle::OddR or Style == OffsetStyle::EvenR) {
+        Integer const q0 = first_col - offset_shift<Style>(row);
+        for (Integer i = 0; i < count; ++i) {
+            *into_hexes++ = hex<Integer>{static_cast<Integer>(q0 + i), row};
+        }
+    }
+    else {
+        for (Integer i = 0; i < count; ++i) {
+            Integer const col = first_col + i;
+            *into_hexes++ = hex<Integer>{
+                col, static_cast<Integer>(row - offset_shift<Style>(col))
+            };
+        }
+    }
+    return into_hexes;
+}
+
+/**
+ * Convert every hex in `[first, last)` to offset coordinates.
+ *
+ * This is the inverse of `offset_map_to_axial`, useful for writing a map back
+ * out in the layout of an external editor.
+ */
+template<OffsetStyle Style, std::input_iterator It, typename Out>
+requires std::weakly_incrementable<Out>
+auto to_offset(It first, It last, Out into_offsets)
+{
+    for (; first != last; ++first) {
+        *into_offsets++ = to_offset<Style>(*first);
+    }
+    return into_offsets;
+}
+}
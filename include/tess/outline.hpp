@@ -0,0 +1,120 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <array>
+#include <vector>
+#include <unordered_set>
+#include <unordered_map>
+#include <iterator>
+#include <cstdint>
+#include <utility>
+
+#include "math.hpp"
+#include "hex.hpp"
+#include "basis.hpp"
+
+namespace tess {
+
+/**
+ * A closed polygon tracing part of the boundary of a set of hexes.
+ *
+ * The last vertex connects back to the first. Outer boundaries and the
+ * boundaries of holes wind in opposite directions.
+ */
+template<cartesian Point>
+struct outline {
+    std::vector<Point> vertices;
+
+    /** Whether this polygon bounds a hole inside a region. */
+    bool is_hole;
+};
+
+/**
+ * Calculate the boundaries of `tiles` as polygons in screen space.
+ *
+ * Edges shared by two tiles of the set are dropped, and the remaining edges
+ * are chained into closed polygons, so each connected region produces one
+ * outer polygon plus one polygon per hole. The vertices of each polygon are
+ * the same ones `Basis::vertices` calculates for the tile it borders.
+ *
+ * \code{.cpp}
+ * std::vector<outline<sf::Vector2f>> borders;
+ * outlines<sf::Vector2f>(basis, territory, std::back_inserter(borders));
+ * \endcode
+ */
+template<cartesian Point, std::floating_point R, HexTop TopStyle,
+         std::ranges::input_range Hexes,
+         std::indirectly_writable<outline<Point>> Out>
+requires std::same_as<std::ranges::range_value_t<Hexes>, hex<int>>
+     and std::weakly_incrementable<Out>
+auto outlines(Basis<R, TopStyle> const & basis, Hexes const & tiles,
+              Out into_outlines)
+{
+    auto const & directions = hex_directions<int>;
+    std::unordered_set<hex<int>> const members(std::ranges::begin(tiles),
+                                               std::ranges::end(tiles));
+
+    // the index of the vertex calculated by Basis::vertices that lies between
+    // directions i and i+1
+    auto const corner_vertex = [](int i) {
+        return TopStyle == HexTop::Pointed? (11 - i) % 6 : (6 - i) % 6;
+    };
+
+    // mark each boundary edge once it has been traced, one bit per direction
+    std::unordered_map<hex<int>, std::uint8_t> traced;
+    auto const is_boundary = [&](hex<int> const & h, int i) {
+        return not members.contains(h + directions[i]);
+    };
+
+    std::vector<hex<int>> ordered(std::ranges::begin(tiles),
+                                  std::ranges::end(tiles));
+    for (auto const & start : ordered) {
+        for (int start_dir = 0; start_dir < 6; ++start_dir) {
+            if (not is_boundary(start, start_dir) or
+                    traced[start] & (1 << start_dir)) {
+                continue;
+            }
+
+            outline<Point> polygon{{}, false};
+            std::array<Point, 6> verts;
+            long long area = 0;
+
+            // walk edges so the region is always on the same side: from each
+            // edge, either turn along the same tile or step onto the tile
+            // that shares the edge's end corner
+            hex<int> h = start;
+            int i = start_dir;
+            do {
+                traced[h] |= static_cast<std::uint8_t>(1 << i);
+                basis.template vertices<Point>(h, verts.begin());
+                polygon.vertices.push_back(verts[corner_vertex((i+5) % 6)]);
+
+                // accumulate the signed area in hex space, scaled by 3 so the
+                // corners have integer coordinates
+                auto const & prev = directions[(i+5) % 6];
+                auto const & here = directions[i];
+                auto const & next = directions[(i+1) % 6];
+                long long const x0 = 3ll*h.q + prev.q + here.q;
+                long long const y0 = 3ll*h.r + prev.r + here.r;
+                long long const x1 = 3ll*h.q + here.q + next.q;
+                long long const y1 = 3ll*h.r + here.r + next.r;
+                area += x0*y1 - x1*y0;
+
+                if (is_boundary(h, (i+1) % 6)) {
+                    i = (i+1) % 6;
+                }
+                else {
+                    h = h + next;
+                    i = (i+5) % 6;
+                }
+            } while (h != start or i != start_dir);
+
+            // edges of a lone hex wind with a negative area in hex space
+            polygon.is_hole = area > 0;
+            *into_outlines++ = std::move(polygon);
+        }
+    }
+    return into_outlines;
+}
+}
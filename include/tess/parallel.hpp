@@ -0,0 +1,63 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <cstddef>
+
+namespace tess {
+
+/**
+ * The number of threads to use when the caller doesn't ask for a number.
+ *
+ * This is the hardware concurrency, or one if it can't be determined.
+ */
+inline unsigned default_threads() noexcept
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Split `[0, count)` into contiguous bands and call `f` on each from its own
+ * thread.
+ *
+ * `f` is called as `f(band, first, last)` where `band` is in
+ * `[0, threads)`. Bands differ in size by at most one, and no more bands are
+ * made than there are elements. The calling thread runs the first band
+ * itself. If any call throws, the first exception is rethrown once every
+ * thread has finished.
+ */
+template<typename F>
+void parallel_for(std::size_t count, unsigned threads, F && f)
+{
+    std::size_t const bands = std::max<std::size_t>(
+        1, std::min<std::size_t>(threads, count));
+    std::vector<std::exception_ptr> errors(bands);
+
+    auto const run = [&](std::size_t band) {
+        std::size_t const first = count * band / bands;
+        std::size_t const last = count * (band+1) / bands;
+        try {
+            f(band, first, last);
+        }
+        catch (...) {
+            errors[band] = std::current_exception();
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(bands - 1);
+        for (std::size_t band = 1; band < bands; ++band) {
+            workers.emplace_back(run, band);
+        }
+        run(0);
+    }
+    for (auto const & error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+}
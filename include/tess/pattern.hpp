@@ -0,0 +1,248 @@
+#pragma once
+
+#include <concepts>
+#include <iterator>
+#include <vector>
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <bit>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+
+#include "hex.hpp"
+#include "hex_set.hpp"
+
+namespace tess {
+
+/** The number of rotations and reflections that map the hex lattice to itself. */
+inline constexpr int hex_symmetry_count = 12;
+
+/**
+ * Rotate and reflect `h` about the zero hex by one of the 12 symmetries of
+ * the hex lattice.
+ *
+ * Symmetries `0` through `5` rotate `h` by that many sixths of a turn, each
+ * turning `hex<Integer>{1, 0}` into `hex<Integer>{0, 1}`. Symmetries `6`
+ * through `11` first reflect `h` across the line through the zero hex and
+ * `hex<Integer>{1, 1}`, then rotate it the same way. Symmetry `0` leaves `h`
+ * as it is.
+ */
+template<std::integral Integer>
+constexpr hex<Integer> hex_symmetry(hex<Integer> h, int symmetry) noexcept
+{
+    if (symmetry >= 6) {
+        h = hex<Integer>{h.r, h.q};
+    }
+    for (int i = 0; i < symmetry % 6; ++i) {
+        h = hex<Integer>{static_cast<Integer>(-h.r),
+                         static_cast<Integer>(h.q + h.r)};
+    }
+    return h;
+}
+
+/**
+ * A shape of tiles to look for, as offsets from an origin.
+ *
+ * A pattern matches where every one of its `present` tiles is set and every
+ * one of its `absent` tiles isn't.
+ *
+ * \code{.cpp}
+ * // three tiles in a row, with nothing at either end
+ * hex_pattern const wall{{{0, 0}, {1, 0}, {2, 0}}, {{-1, 0}, {3, 0}}};
+ * \endcode
+ */
+class hex_pattern {
+public:
+    /**
+     * Create a pattern of `present` tiles and `absent` tiles.
+     *
+     * \throws std::invalid_argument if there are no tiles, or if a tile is
+     *         both present and absent.
+     */
+    hex_pattern(std::vector<hex<int>> present,
+                std::vector<hex<int>> absent = {})
+
+        : _present{std::move(present)}, _absent{std::move(absent)}
+    {
+        if (_present.empty() and _absent.empty()) {
+            throw std::invalid_argument{"a pattern must have tiles"};
+        }
+        for (auto const & h : _absent) {
+            if (std::ranges::find(_present, h) != _present.end()) {
+                throw std::invalid_argument{
+                    "a pattern tile can't be both present and absent"};
+            }
+        }
+    }
+
+    /** The offsets of the tiles that must be set. */
+    std::vector<hex<int>> const & present() const noexcept { return _present; }
+
+    /** The offsets of the tiles that must not be set. */
+    std::vector<hex<int>> const & absent() const noexcept { return _absent; }
+
+    /** This pattern rotated and reflected by `hex_symmetry`. */
+    hex_pattern transformed(int symmetry) const
+    {
+        auto const transform = [symmetry](std::vector<hex<int>> tiles) {
+            for (auto & h : tiles) {
+                h = hex_symmetry(h, symmetry);
+            }
+            return tiles;
+        };
+        return hex_pattern{transform(_present), transform(_absent)};
+    }
+
+private:
+    std::vector<hex<int>> _present;
+    std::vector<hex<int>> _absent;
+};
+
+/**
+ * A place where a pattern matches.
+ *
+ * The pattern's tile at offset `p` lies at
+ * `origin + hex_symmetry(p, symmetry)`.
+ */
+struct pattern_match {
+    hex<int> origin;
+    int symmetry;
+};
+
+inline bool operator==(pattern_match const & a, pattern_match const & b)
+{
+    return a.origin == b.origin and a.symmetry == b.symmetry;
+}
+
+namespace detail {
+
+// a pattern's tiles shifted so their smallest q and r are zero
+struct placed_pattern {
+    std::vector<hex<int>> present;
+    std::vector<hex<int>> absent;
+    hex<int> shift;
+    int width, height;
+
+    explicit placed_pattern(hex_pattern const & pattern)
+
+        : present{pattern.present()}, absent{pattern.absent()}
+    {
+        int q0 = present.empty()? absent[0].q : present[0].q;
+        int r0 = present.empty()? absent[0].r : present[0].r;
+        int q1 = q0;
+        int r1 = r0;
+        for (auto const * tiles : {&present, &absent}) {
+            for (auto const & h : *tiles) {
+                q0 = std::min(q0, h.q);
+                q1 = std::max(q1, h.q);
+                r0 = std::min(r0, h.r);
+                r1 = std::max(r1, h.r);
+            }
+        }
+        shift = hex<int>{q0, r0};
+        width = q1 - q0 + 1;
+        height = r1 - r0 + 1;
+        auto const row_major = [](hex<int> const & a, hex<int> const & b) {
+            return std::tie(a.r, a.q) < std::tie(b.r, b.q);
+        };
+        for (auto * tiles : {&present, &absent}) {
+            for (auto & h : *tiles) {
+                h = h - shift;
+            }
+            std::ranges::sort(*tiles, row_major);
+        }
+    }
+
+    bool same_shape(placed_pattern const & other) const
+    {
+        return present == other.present and absent == other.absent;
+    }
+};
+
+// the bits of a packed row starting from column `64*word + shift`
+inline std::uint64_t row_bits(std::uint64_t const * row, std::size_t words,
+                              std::size_t word, int shift) noexcept
+{
+    std::size_t const i = word + static_cast<std::size_t>(shift / 64);
+    int const bit = shift % 64;
+    std::uint64_t const low = i < words? row[i] : 0;
+    std::uint64_t const high = i+1 < words? row[i+1] : 0;
+    return bit == 0? low : (low >> bit) | (high << (64 - bit));
+}
+}
+
+/**
+ * Find every place in `tiles` where `pattern` matches, and write each as a
+ * `pattern_match`.
+ *
+ * Only placements that lie entirely within the region of `tiles` are
+ * matched. With `symmetries` set, every rotation and reflection of the
+ * pattern is tried too, and each distinct shape is reported under the first
+ * symmetry that produces it, so a symmetric pattern isn't matched twice in the
+ * same place. Rows are matched 64 origins at a time by shifting and combining
+ * the packed words of `tiles`, one pattern tile after another.
+ *
+ * \code{.cpp}
+ * std::vector<pattern_match> sites;
+ * match_pattern(buildable, farm_footprint, std::back_inserter(sites));
+ * \endcode
+ */
+template<std::indirectly_writable<pattern_match> Out>
+requires std::weakly_incrementable<Out>
+auto match_pattern(hex_set const & tiles, hex_pattern const & pattern,
+                   Out into_matches, bool symmetries = true)
+{
+    std::vector<std::pair<int, detail::placed_pattern>> shapes;
+    int const count = symmetries? hex_symmetry_count : 1;
+    for (int s = 0; s < count; ++s) {
+        detail::placed_pattern placed{pattern.transformed(s)};
+        bool const repeated = std::ranges::any_of(shapes,
+            [&placed](auto const & shape) {
+                return shape.second.same_shape(placed);
+            });
+        if (not repeated) {
+            shapes.emplace_back(s, std::move(placed));
+        }
+    }
+
+    std::size_t const words = tiles.row_words();
+    for (auto const & [symmetry, shape] : shapes) {
+        int const last_q = tiles.width() - shape.width;
+        int const last_r = tiles.height() - shape.height;
+        if (last_q < 0 or last_r < 0) {
+            continue;
+        }
+        for (int r = 0; r <= last_r; ++r) {
+            for (std::size_t word = 0; word*64 <= std::size_t(last_q); ++word) {
+                std::uint64_t matched = ~std::uint64_t{0};
+                for (auto const & h : shape.present) {
+                    auto const * row = tiles.data() + (r + h.r) * words;
+                    matched &= detail::row_bits(row, words, word, h.q);
+                    if (not matched) break;
+                }
+                for (auto const & h : shape.absent) {
+                    auto const * row = tiles.data() + (r + h.r) * words;
+                    matched &= ~detail::row_bits(row, words, word, h.q);
+                }
+
+                // drop origins whose placement runs past the east edge
+                int const past = last_q - static_cast<int>(word*64);
+                if (past < 63) {
+                    matched &= (std::uint64_t{2} << past) - 1;
+                }
+                while (matched) {
+                    int const bit = std::countr_zero(matched);
+                    matched &= matched - 1;
+                    auto const anchor = tiles.origin()
+                        + hex<int>{static_cast<int>(word*64) + bit, r};
+                    *into_matches++ = pattern_match{anchor - shape.shift,
+                                                    symmetry};
+                }
+            }
+        }
+    }
+    return into_matches;
+}
+}
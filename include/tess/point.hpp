@@ -91,31 +91,31 @@ template<typename T>
  * This is equivalent to \f$p \cdot p\f$ or \f$p_x^2 + p_y^2\f$.
  */
 template<typename T>
-    T sqnorm(const point<T>& p) noexcept
+    constexpr T sqnorm(const point<T>& p) noexcept
     {
         return p.x*p.x + p.y*p.y;
     }
 
 template<typename T>
-    point<T> operator+(const point<T>& p, const point<T>& q)
+    constexpr point<T> operator+(const point<T>& p, const point<T>& q)
     {
         return point{ p.x+q.x, p.y+q.y };
     }
 
 template<typename T>
-    point<T> operator-(const point<T>& p)
+    constexpr point<T> operator-(const point<T>& p)
     {
         return point{ -p.x, -p.y };
     }
 
 template<typename T>
-    point<T> operator-(const point<T>& p, const point<T>& q)
+    constexpr point<T> operator-(const point<T>& p, const point<T>& q)
     {
         return p + (-q);
     }
 
 template<typename T>
-    bool operator==(const point<T>& a, const point<T>& b)
+    constexpr bool operator==(const point<T>& a, const point<T>& b)
     {
         return a.x == b.x && a.y == b.y;
     }
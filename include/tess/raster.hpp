@@ -0,0 +1,421 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <utility>
+#include <cmath>
+#include <numbers>
+#include <limits>
+
+#include "math.hpp"
+#include "hex.hpp"
+#include "point.hpp"
+#include "basis.hpp"
+
+namespace tess {
+namespace detail {
+
+/**
+ * The geometry of a pointed-top hex tiling with its origin at zero.
+ *
+ * Flat-top tilings are handled by swapping the x and y axes, which turns them
+ * into a pointed-top tiling with the q and r axes swapped.
+ */
+template<std::floating_point R>
+struct pointed_tiling {
+    R size;
+    R width;
+    std::array<point<R>, 6> corners;
+
+    explicit pointed_tiling(R size)
+        : size{size}, width{std::sqrt(R(3)) * size}
+    {
+        R constexpr pi = std::numbers::pi_v<R>;
+        for (int i = 0; i < 6; ++i) {
+            R const theta = pi/6 + i * pi/3;
+            corners[i] = point<R>{size * std::cos(theta),
+                                  size * std::sin(theta)};
+        }
+    }
+
+    point<R> center(int q, int r) const noexcept
+    {
+        return point<R>{width * (q + r/R(2)), size * R(1.5) * r};
+    }
+
+    /** Determine if `p` lies strictly inside the hex centered at `c`. */
+    bool inside(point<R> const & c, point<R> const & p) const noexcept
+    {
+        R const apothem = width/2;
+        R const dx = p.x - c.x;
+        R const dy = p.y - c.y;
+        R const half = std::sqrt(R(3))/2;
+        return std::abs(dx) < apothem
+           and std::abs(dx/2 + dy*half) < apothem
+           and std::abs(-dx/2 + dy*half) < apothem;
+    }
+};
+
+template<std::floating_point R>
+R segment_distance(point<R> const & p, point<R> const & a,
+                   point<R> const & b) noexcept
+{
+    auto const ab = b - a;
+    auto const ap = p - a;
+    R const length = sqnorm(ab);
+    R t = length > 0? (ap.x*ab.x + ap.y*ab.y) / length : R(0);
+    t = std::clamp(t, R(0), R(1));
+    point<R> const d{ap.x - t*ab.x, ap.y - t*ab.y};
+    return std::sqrt(sqnorm(d));
+}
+
+template<std::floating_point R>
+bool segments_cross(point<R> const & a, point<R> const & b,
+                    point<R> const & c, point<R> const & d) noexcept
+{
+    auto const cross = [](point<R> const & u, point<R> const & v) {
+        return u.x*v.y - u.y*v.x;
+    };
+    R const d1 = cross(b - a, c - a);
+    R const d2 = cross(b - a, d - a);
+    R const d3 = cross(d - c, a - c);
+    R const d4 = cross(d - c, b - c);
+    return ((d1 > 0 and d2 < 0) or (d1 < 0 and d2 > 0))
+       and ((d3 > 0 and d4 < 0) or (d3 < 0 and d4 > 0));
+}
+
+/** The distance between segment `[a, b]` and the hex centered at `c`. */
+template<std::floating_point R>
+R hex_distance(pointed_tiling<R> const & tiling, point<R> const & c,
+               point<R> const & a, point<R> const & b) noexcept
+{
+    if (tiling.inside(c, a)) {
+        return 0;
+    }
+    R nearest = segment_distance(c + tiling.corners[0], a, b);
+    for (int i = 0; i < 6; ++i) {
+        auto const u = c + tiling.corners[i];
+        auto const v = c + tiling.corners[(i+1) % 6];
+        if (segments_cross(a, b, u, v)) {
+            return 0;
+        }
+        nearest = std::min({nearest, segment_distance(u, a, b),
+                            segment_distance(a, u, v),
+                            segment_distance(b, u, v)});
+    }
+    return nearest;
+}
+
+/** The x extent of the disk at `c` with `radius` within `[y0, y1]`. */
+template<std::floating_point R>
+std::optional<std::pair<R, R>>
+disk_extent(point<R> const & c, R radius, R y0, R y1) noexcept
+{
+    R const dy = std::clamp(c.y, y0, y1) - c.y;
+    if (dy*dy >= radius*radius) {
+        return std::nullopt;
+    }
+    R const half = std::sqrt(radius*radius - dy*dy);
+    return std::pair{c.x - half, c.x + half};
+}
+
+/** The x extent of the convex polygon `verts` within `[y0, y1]`. */
+template<std::floating_point R>
+std::optional<std::pair<R, R>>
+polygon_extent(std::vector<point<R>> const & verts, R y0, R y1) noexcept
+{
+    std::optional<std::pair<R, R>> extent;
+    auto const include = [&extent](R x) {
+        if (extent) {
+            extent->first = std::min(extent->first, x);
+            extent->second = std::max(extent->second, x);
+        }
+        else {
+            extent = std::pair{x, x};
+        }
+    };
+    for (std::size_t i = 0; i < verts.size(); ++i) {
+        auto a = verts[i];
+        auto b = verts[(i+1) % verts.size()];
+        if (a.y > b.y) {
+            std::swap(a, b);
+        }
+        if (b.y < y0 or a.y > y1) {
+            continue;
+        }
+        // clip the edge to the slab
+        auto const at = [&a, &b](R y) {
+            return b.y == a.y? a.x : a.x + (b.x - a.x) * (y - a.y)/(b.y - a.y);
+        };
+        include(a.y < y0? at(y0) : a.x);
+        include(b.y > y1? at(y1) : b.x);
+    }
+    return extent;
+}
+
+/** Determine if the convex polygon `verts` overlaps the hex at `c`. */
+template<std::floating_point R>
+bool polygon_overlaps(pointed_tiling<R> const & tiling,
+                      std::vector<point<R>> const & verts,
+                      point<R> const & c) noexcept
+{
+    auto const separated = [&](point<R> const & axis) {
+        R hex_min = std::numeric_limits<R>::max();
+        R hex_max = std::numeric_limits<R>::lowest();
+        for (auto const & corner : tiling.corners) {
+            R const d = (c.x + corner.x)*axis.x + (c.y + corner.y)*axis.y;
+            hex_min = std::min(hex_min, d);
+            hex_max = std::max(hex_max, d);
+        }
+        R poly_min = std::numeric_limits<R>::max();
+        R poly_max = std::numeric_limits<R>::lowest();
+        for (auto const & v : verts) {
+            R const d = v.x*axis.x + v.y*axis.y;
+            poly_min = std::min(poly_min, d);
+            poly_max = std::max(poly_max, d);
+        }
+        return poly_max <= hex_min or hex_max <= poly_min;
+    };
+    for (int i = 0; i < 3; ++i) {
+        auto const edge = tiling.corners[i+1] - tiling.corners[i];
+        if (separated(point<R>{-edge.y, edge.x})) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < verts.size(); ++i) {
+        auto const edge = verts[(i+1) % verts.size()] - verts[i];
+        if (separated(point<R>{-edge.y, edge.x})) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Write every hex overlapping a convex shape, one row at a time.
+ *
+ * `extent(y0, y1)` gives the x extent of the shape within a horizontal slab,
+ * and `overlaps(c)` determines if the shape overlaps the hex centered at `c`.
+ * Hexes of a row that overlap a convex shape are contiguous, so only the ends
+ * of each row's candidate range need to be tested exactly.
+ */
+template<std::floating_point R, HexTop TopStyle, typename Extent,
+         typename Overlaps, typename Out>
+Out rasterize(pointed_tiling<R> const & tiling, R y_min, R y_max,
+              Extent && extent, Overlaps && overlaps, Out into_hexes)
+{
+    R const row_height = tiling.size * R(1.5);
+    int const first = static_cast<int>(std::floor((y_min - tiling.size)
+                                                  / row_height));
+    int const last = static_cast<int>(std::ceil((y_max + tiling.size)
+                                                / row_height));
+    for (int r = first; r <= last; ++r) {
+        R const y = row_height * r;
+        auto const span = extent(y - tiling.size, y + tiling.size);
+        if (not span) {
+            continue;
+        }
+        R const w = tiling.width;
+        int lo = static_cast<int>(std::floor((span->first - w/2)/w - r/R(2)));
+        int hi = static_cast<int>(std::ceil((span->second + w/2)/w - r/R(2)));
+        while (lo <= hi and not overlaps(tiling.center(lo, r))) {
+            ++lo;
+        }
+        while (hi >= lo and not overlaps(tiling.center(hi, r))) {
+            --hi;
+        }
+        for (int q = lo; q <= hi; ++q) {
+            if constexpr (TopStyle == HexTop::Pointed) {
+                *into_hexes++ = hex<int>{q, r};
+            }
+            else {
+                *into_hexes++ = hex<int>{r, q};
+            }
+        }
+    }
+    return into_hexes;
+}
+
+/** Convert a screen space point into the local space of `rasterize`. */
+template<std::floating_point R, HexTop TopStyle, cartesian Point>
+point<R> local_point(Basis<R, TopStyle> const & basis, Point const & p)
+{
+    auto const origin = basis.template origin<point<R>>();
+    point<R> const local{static_cast<R>(p.x) - origin.x,
+                         static_cast<R>(p.y) - origin.y};
+    if constexpr (TopStyle == HexTop::Pointed) {
+        return local;
+    }
+    else {
+        return point<R>{local.y, local.x};
+    }
+}
+
+template<std::floating_point R, HexTop TopStyle, typename Out>
+Out rasterize_capsule(Basis<R, TopStyle> const & basis,
+                      point<R> const & a, point<R> const & b,
+                      R radius, Out into_hexes)
+{
+    pointed_tiling<R> const tiling{basis.unit_size()};
+
+    // a capsule is the union of its end disks and the rectangle between them
+    std::vector<point<R>> body;
+    auto const ab = b - a;
+    R const length = std::sqrt(sqnorm(ab));
+    if (length > 0) {
+        point<R> const n{-ab.y/length * radius, ab.x/length * radius};
+        body = {a + n, b + n, b - n, a - n};
+    }
+    auto const extent = [&](R y0, R y1) {
+        auto span = disk_extent(a, radius, y0, y1);
+        for (auto const & other : { disk_extent(b, radius, y0, y1),
+                                    polygon_extent(body, y0, y1) }) {
+            if (other and span) {
+                span->first = std::min(span->first, other->first);
+                span->second = std::max(span->second, other->second);
+            }
+            else if (other) {
+                span = other;
+            }
+        }
+        return span;
+    };
+    auto const overlaps = [&](point<R> const & c) {
+        return hex_distance(tiling, c, a, b) < radius;
+    };
+    return rasterize<R, TopStyle>(tiling, std::min(a.y, b.y) - radius,
+                                  std::max(a.y, b.y) + radius,
+                                  extent, overlaps, into_hexes);
+}
+}
+
+/**
+ * Calculate the hexes overlapping the convex polygon `polygon`.
+ *
+ * `polygon` lists the vertices of the polygon in screen space, in either
+ * winding order, and may repeat its first vertex at the end to close it. A hex overlaps the polygon if they share some area, so hexes
+ * that only touch the polygon's boundary aren't included. Each hex is written
+ * once, one row of the tiling at a time.
+ *
+ * \code{.cpp}
+ * std::vector<point<float>> const selection{{10, 10}, {90, 10},
+ *                                           {90, 70}, {10, 70}};
+ * std::vector<hex<int>> selected;
+ * rasterize_polygon(basis, selection, std::back_inserter(selected));
+ * \endcode
+ */
+template<std::floating_point R, HexTop TopStyle,
+         std::ranges::forward_range Polygon,
+         std::indirectly_writable<hex<int>> Out>
+requires cartesian<std::ranges::range_value_t<Polygon>>
+     and std::weakly_incrementable<Out>
+auto rasterize_polygon(Basis<R, TopStyle> const & basis,
+                       Polygon const & polygon, Out into_hexes)
+{
+    // repeated vertices, such as a closing copy of the first vertex, would
+    // make zero-length edges whose axes separate the polygon from every hex
+    std::vector<point<R>> verts;
+    for (auto const & p : polygon) {
+        auto const v = detail::local_point(basis, p);
+        if (verts.empty() or verts.back() != v) {
+            verts.push_back(v);
+        }
+    }
+    while (verts.size() > 1 and verts.back() == verts.front()) {
+        verts.pop_back();
+    }
+    if (verts.size() < 3) {
+        return into_hexes;
+    }
+
+    detail::pointed_tiling<R> const tiling{basis.unit_size()};
+    auto const [low, high] = std::ranges::minmax(verts | std::views::transform(
+        [](point<R> const & v) { return v.y; }));
+    auto const extent = [&verts](R y0, R y1) {
+        return detail::polygon_extent(verts, y0, y1);
+    };
+    auto const overlaps = [&tiling, &verts](point<R> const & c) {
+        return detail::polygon_overlaps(tiling, verts, c);
+    };
+    return detail::rasterize<R, TopStyle>(tiling, low, high, extent, overlaps,
+                                          into_hexes);
+}
+
+/**
+ * Calculate the hexes overlapping the circle at `center` with `radius`.
+ *
+ * `center` and `radius` are measured in screen space. Hexes that only touch
+ * the circle are not included.
+ */
+template<std::floating_point R, HexTop TopStyle, cartesian Point,
+         std::indirectly_writable<hex<int>> Out>
+requires std::weakly_incrementable<Out>
+auto rasterize_circle(Basis<R, TopStyle> const & basis, Point const & center,
+                      R radius, Out into_hexes)
+{
+    auto const c = detail::local_point(basis, center);
+    return detail::rasterize_capsule(basis, c, c, radius, into_hexes);
+}
+
+/**
+ * Calculate the hexes overlapping the capsule around segment `[a, b]`.
+ *
+ * The capsule contains every point within `radius` of the segment, measured
+ * in screen space, so these are the hexes swept by a circle of `radius` moving
+ * from `a` to `b`. Unlike a `line` between the hexes of `a` and `b`, this
+ * includes every hex the circle grazes along the way. Hexes that only touch
+ * the capsule are not included.
+ *
+ * \code{.cpp}
+ * std::vector<hex<int>> swept;
+ * rasterize_capsule(basis, bullet.position, bullet.next_position,
+ *                   bullet.radius, std::back_inserter(swept));
+ * bool const hit = std::ranges::any_of(swept, [&](hex<int> const & h) {
+ *     return occupied.contains(h);
+ * });
+ * \endcode
+ */
+template<std::floating_point R, HexTop TopStyle, cartesian Point,
+         std::indirectly_writable<hex<int>> Out>
+requires std::weakly_incrementable<Out>
+auto rasterize_capsule(Basis<R, TopStyle> const & basis, Point const & a,
+                       Point const & b, R radius, Out into_hexes)
+{
+    return detail::rasterize_capsule(basis, detail::local_point(basis, a),
+                                     detail::local_point(basis, b), radius,
+                                     into_hexes);
+}
+
+/**
+ * Calculate the hexes overlapping the line from `a` to `b` drawn `thickness`
+ * wide.
+ *
+ * The line is the rectangle reaching `thickness/2` to either side of segment
+ * `[a, b]` in screen space, with square ends at `a` and `b`; use
+ * `rasterize_capsule` for round ends. Hexes that only touch the line are not
+ * included, and a line without length or thickness covers no hexes.
+ */
+template<std::floating_point R, HexTop TopStyle, cartesian Point,
+         std::indirectly_writable<hex<int>> Out>
+requires std::weakly_incrementable<Out>
+auto rasterize_line(Basis<R, TopStyle> const & basis, Point const & a,
+                    Point const & b, R thickness, Out into_hexes)
+{
+    point<R> const from{static_cast<R>(a.x), static_cast<R>(a.y)};
+    point<R> const to{static_cast<R>(b.x), static_cast<R>(b.y)};
+    auto const ab = to - from;
+    R const length = std::sqrt(sqnorm(ab));
+    if (not (length > 0 and thickness > 0)) {
+        return into_hexes;
+    }
+    R const half = thickness/2 / length;
+    point<R> const n{-ab.y * half, ab.x * half};
+    std::array<point<R>, 4> const body{from + n, to + n, to - n, from - n};
+    return rasterize_polygon(basis, body, into_hexes);
+}
+}
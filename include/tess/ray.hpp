@@ -0,0 +1,205 @@
+#pragma once
+
+#include <concepts>
+#include <iterator>
+#include <optional>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+#include "math.hpp"
+#include "hex.hpp"
+#include "point.hpp"
+#include "basis.hpp"
+
+namespace tess {
+
+/** A stretch of a ray that lies within one hex. */
+template<std::floating_point R>
+struct ray_crossing {
+    /** The hex the ray passes through. */
+    hex<int> tile;
+
+    /** The distance along the ray at which it enters `tile`. */
+    R enter;
+
+    /** The distance along the ray at which it leaves `tile`. */
+    R exit;
+};
+
+/**
+ * Walks a ray through the hexes of a tiling, one hex at a time.
+ *
+ * The ray starts in the hex containing its origin and moves to the neighbor
+ * across whichever edge it leaves through, so every hex the ray passes through
+ * is visited exactly once, in order. Distances are measured along the ray in
+ * screen space, from its origin.
+ *
+ * Each step only compares the ray against the three edges it's heading
+ * towards, which are fixed lines of hex space, so stepping costs a few
+ * multiplications and no rounding.
+ *
+ * \code{.cpp}
+ * hex_ray ray{basis, muzzle, aim};
+ * while (ray.enter() < range and not walls.contains(ray.tile())) {
+ *     ray.advance();
+ * }
+ * \endcode
+ */
+template<std::floating_point R>
+class hex_ray {
+public:
+    /**
+     * Create a ray in the tiling of `basis` from `origin` towards
+     * `direction`, both in screen space.
+     *
+     * \throws std::invalid_argument if `direction` has no length.
+     */
+    template<HexTop TopStyle, cartesian Point>
+    hex_ray(Basis<R, TopStyle> const & basis, Point const & origin,
+            Point const & direction)
+    {
+        point<R> const from{static_cast<R>(origin.x), static_cast<R>(origin.y)};
+        point<R> d{static_cast<R>(direction.x), static_cast<R>(direction.y)};
+        R const length = std::sqrt(sqnorm(d));
+        if (not (length > 0)) {
+            throw std::invalid_argument{"a ray's direction must have length"};
+        }
+        d = point<R>{d.x / length, d.y / length};
+
+        // screen space maps linearly onto hex space, so the ray stays straight
+        _origin = basis.hex(from);
+        _direction = basis.hex(from + d) - _origin;
+        _tile = hex_round<int>(_origin);
+        _enter = 0;
+        find_exit();
+    }
+
+    /** The hex the ray is passing through. */
+    hex<int> tile() const noexcept { return _tile; }
+
+    /** The distance along the ray at which it enters `tile()`. */
+    R enter() const noexcept { return _enter; }
+
+    /** The distance along the ray at which it leaves `tile()`. */
+    R exit() const noexcept { return _exit; }
+
+    /** The current hex with its entry and exit distances. */
+    ray_crossing<R> crossing() const noexcept
+    {
+        return ray_crossing<R>{_tile, _enter, _exit};
+    }
+
+    /** Move on to the next hex along the ray. */
+    void advance() noexcept
+    {
+        _tile = _tile + hex_directions<int>[_side];
+        _enter = _exit;
+        find_exit();
+    }
+
+private:
+    hex<R> _origin;
+    hex<R> _direction;
+    hex<int> _tile;
+    R _enter;
+    R _exit;
+    int _side;
+
+    // the edge between a tile and its neighbor `e` is where
+    // `dot(p - tile, e) == 1`, with hexes taken as cube coordinates
+    void find_exit() noexcept
+    {
+        hex<R> const local = _origin - hex<R>{static_cast<R>(_tile.q),
+                                              static_cast<R>(_tile.r)};
+        _exit = std::numeric_limits<R>::infinity();
+        _side = 0;
+        for (int i = 0; i < 6; ++i) {
+            auto const & e = hex_directions<int>[i];
+            R const speed = e.q*_direction.q + e.r*_direction.r
+                          + e.s()*_direction.s();
+            if (not (speed > 0)) {
+                continue;
+            }
+            R const at = e.q*local.q + e.r*local.r + e.s()*local.s();
+            R const t = (1 - at) / speed;
+            if (t < _exit) {
+                _exit = t;
+                _side = i;
+            }
+        }
+        _exit = std::max(_exit, _enter);
+    }
+};
+
+template<std::floating_point R, HexTop TopStyle, cartesian Point>
+hex_ray(Basis<R, TopStyle> const &, Point const &, Point const &)
+    -> hex_ray<R>;
+
+/**
+ * Calculate every hex the ray from `origin` towards `direction` passes
+ * through within `max_distance` of its origin, along with where it enters
+ * and leaves each one.
+ *
+ * Everything is measured in the screen space of `basis`. The ray ends at
+ * `max_distance`, so the exit of the last hex is at most `max_distance`.
+ *
+ * \code{.cpp}
+ * std::vector<ray_crossing<float>> lit;
+ * trace_ray(basis, lamp, facing, 200.f, std::back_inserter(lit));
+ * \endcode
+ *
+ * \throws std::invalid_argument if `direction` has no length or if
+ *         `max_distance` is negative or not a number.
+ */
+template<std::floating_point R, HexTop TopStyle, cartesian Point,
+         std::indirectly_writable<ray_crossing<R>> Out>
+requires std::weakly_incrementable<Out>
+auto trace_ray(Basis<R, TopStyle> const & basis, Point const & origin,
+               Point const & direction, R max_distance, Out into_crossings)
+{
+    if (not (max_distance >= 0)) {
+        throw std::invalid_argument{"a ray's length must not be negative"};
+    }
+    hex_ray<R> ray{basis, origin, direction};
+    while (true) {
+        auto crossing = ray.crossing();
+        if (crossing.exit >= max_distance) {
+            crossing.exit = max_distance;
+            *into_crossings++ = crossing;
+            return into_crossings;
+        }
+        *into_crossings++ = crossing;
+        ray.advance();
+    }
+}
+
+/**
+ * Find the first hex along the ray from `origin` towards `direction` for
+ * which `is_opaque` holds, within `max_distance` of the ray's origin.
+ *
+ * \return the crossing of the hex that stops the ray, or nothing if the ray
+ *         gets through.
+ *
+ * \throws std::invalid_argument if `direction` has no length or if
+ *         `max_distance` is negative or not a number.
+ */
+template<std::floating_point R, HexTop TopStyle, cartesian Point,
+         std::predicate<hex<int> const &> Opaque>
+std::optional<ray_crossing<R>>
+cast_ray(Basis<R, TopStyle> const & basis, Point const & origin,
+         Point const & direction, R max_distance, Opaque && is_opaque)
+{
+    if (not (max_distance >= 0)) {
+        throw std::invalid_argument{"a ray's length must not be negative"};
+    }
+    for (hex_ray<R> ray{basis, origin, direction}; ray.enter() <= max_distance;
+         ray.advance()) {
+        if (is_opaque(ray.tile())) {
+            return ray.crossing();
+        }
+    }
+    return std::nullopt;
+}
+}
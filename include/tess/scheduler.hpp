@@ -0,0 +1,276 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <barrier>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+
+#include "hex.hpp"
+#include "parallel.hpp"
+
+namespace tess {
+
+/** A rectangular block of tiles updated as one unit of work. */
+struct hex_chunk {
+    /** The position of this chunk among the others, in chunks. */
+    int column, row;
+
+    /** The hex of the first tile of this chunk. */
+    hex<int> origin;
+
+    /** The number of tiles in each row of this chunk. */
+    int width;
+
+    /** The number of rows in this chunk. */
+    int height;
+
+    /** The phase this chunk is updated in. */
+    int color;
+
+    /** Determine if `h` is one of the tiles of this chunk. */
+    bool contains(hex<int> const & h) const noexcept
+    {
+        int const q = h.q - origin.q;
+        int const r = h.r - origin.r;
+        return 0 <= q and q < width and 0 <= r and r < height;
+    }
+};
+
+/**
+ * Runs a simulation over a region of tiles chunk by chunk, on many threads.
+ *
+ * The region is the same parallelogram a `hex_grid` covers, cut into chunks
+ * of `chunk_width` by `chunk_height` tiles. Each tick calls an update on every
+ * chunk once. An update may write to the tiles of its own chunk and read any
+ * tile within `halo` of it.
+ *
+ * Chunks are colored so that no chunk's halo reaches another chunk of the same
+ * color, and a tick runs one color after another. Chunks of one color run in
+ * parallel with no further locking, and updates of later colors see the
+ * tiles written by earlier ones. A halo of at most one needs three colors and
+ * a wider halo needs four. Within a color, each thread works through its own
+ * queue of chunks and steals from the others once it runs dry, so uneven
+ * chunks still keep every thread busy.
+ *
+ * The threads are started once, when the scheduler is made, and wait between
+ * ticks.
+ *
+ * \code{.cpp}
+ * hex_grid<float> heat{origin, 4096, 4096};
+ * chunk_scheduler scheduler{origin, 4096, 4096, 64, 64};
+ * scheduler.tick([&](hex_chunk const & chunk) {
+ *     for (int r = 0; r < chunk.height; ++r) {
+ *         for (int q = 0; q < chunk.width; ++q) {
+ *             auto const h = chunk.origin + hex<int>{q, r};
+ *             heat[h] = cool(heat, h);  // reads neighbors of h
+ *         }
+ *     }
+ * });
+ * \endcode
+ */
+class chunk_scheduler {
+public:
+    /**
+     * Cut the `width` by `height` region at `origin` into chunks, to be
+     * updated by `threads` threads.
+     *
+     * \throws std::invalid_argument if `width` or `height` is negative, if the
+     *         chunk dimensions aren't positive, or if `halo` is negative or
+     *         wider than a chunk.
+     */
+    chunk_scheduler(hex<int> const & origin, int width, int height,
+                    int chunk_width, int chunk_height, int halo = 1,
+                    unsigned threads = default_threads())
+
+        : _halo{halo}, _colors{halo <= 1? 3 : 4},
+          _threads{std::max(1u, threads)},
+          _queues(_threads),
+          _start{static_cast<std::ptrdiff_t>(_threads)},
+          _done{static_cast<std::ptrdiff_t>(_threads)}
+    {
+        if (width < 0 or height < 0) {
+            throw std::invalid_argument{
+                "chunk_scheduler dimensions must not be negative"};
+        }
+        if (chunk_width <= 0 or chunk_height <= 0) {
+            throw std::invalid_argument{"chunk dimensions must be positive"};
+        }
+        if (halo < 0 or halo > std::min(chunk_width, chunk_height)) {
+            throw std::invalid_argument{
+                "chunk halo must be between zero and the chunk size"};
+        }
+
+        _columns = (width + chunk_width - 1) / chunk_width;
+        _rows = (height + chunk_height - 1) / chunk_height;
+        for (int j = 0; j < _rows; ++j) {
+            for (int i = 0; i < _columns; ++i) {
+                int const q = i * chunk_width;
+                int const r = j * chunk_height;
+                _chunks.push_back(hex_chunk{
+                    i, j, origin + hex<int>{q, r},
+                    std::min(chunk_width, width - q),
+                    std::min(chunk_height, height - r),
+                    color_of(i, j)
+                });
+            }
+        }
+
+        _workers.reserve(_threads - 1);
+        for (unsigned id = 1; id < _threads; ++id) {
+            _workers.emplace_back([this, id] { serve(id); });
+        }
+    }
+
+    chunk_scheduler(chunk_scheduler const &) = delete;
+    chunk_scheduler & operator=(chunk_scheduler const &) = delete;
+
+    ~chunk_scheduler()
+    {
+        _stopping = true;
+        _start.arrive_and_wait();
+    }
+
+    /** The number of chunks in each row of chunks. */
+    int columns() const noexcept { return _columns; }
+
+    /** The number of rows of chunks. */
+    int rows() const noexcept { return _rows; }
+
+    /** The number of colors, and so of phases in each tick. */
+    int colors() const noexcept { return _colors; }
+
+    /** The furthest a chunk's update may read past its own tiles. */
+    int halo() const noexcept { return _halo; }
+
+    /** Every chunk, row by row. */
+    std::vector<hex_chunk> const & chunks() const noexcept { return _chunks; }
+
+    /**
+     * Call `update(chunk)` on every chunk, one color at a time.
+     *
+     * If any update throws, the remaining chunks of its color are still
+     * finished, later colors are skipped, and the first exception is
+     * rethrown.
+     */
+    template<typename F>
+    void tick(F && update)
+    {
+        using Task = std::remove_reference_t<F>;
+        _task = const_cast<void *>(static_cast<void const *>(&update));
+        _run = [](void * task, hex_chunk const & chunk) {
+            (*static_cast<Task *>(task))(chunk);
+        };
+        for (int color = 0; color < _colors and not _error; ++color) {
+            fill_queues(color);
+            _start.arrive_and_wait();
+            work(0);
+            _done.arrive_and_wait();
+        }
+        if (auto const error = std::exchange(_error, nullptr)) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct alignas(64) queue {
+        std::mutex mutex;
+        std::deque<std::size_t> chunks;
+    };
+
+    int _halo;
+    int _colors;
+    int _columns = 0;
+    int _rows = 0;
+    unsigned _threads;
+    std::vector<hex_chunk> _chunks;
+
+    std::vector<queue> _queues;
+    std::barrier<> _start;
+    std::barrier<> _done;
+    std::atomic<bool> _stopping = false;
+    std::mutex _error_mutex;
+    std::exception_ptr _error;
+    void * _task = nullptr;
+    void (*_run)(void *, hex_chunk const &) = nullptr;
+    std::vector<std::jthread> _workers;
+
+    // neighboring chunks differ by (1, 0), (0, 1) or (1, -1) in chunk
+    // coordinates, and with a halo wider than one also by (1, 1)
+    int color_of(int i, int j) const noexcept
+    {
+        if (_colors == 3) {
+            return ((i - j) % 3 + 3) % 3;
+        }
+        return (i & 1) + 2*(j & 1);
+    }
+
+    void fill_queues(int color)
+    {
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < _chunks.size(); ++i) {
+            if (_chunks[i].color == color) {
+                _queues[next++ % _threads].chunks.push_back(i);
+            }
+        }
+    }
+
+    bool take(unsigned id, std::size_t & chunk)
+    {
+        {
+            auto & own = _queues[id];
+            std::scoped_lock lock{own.mutex};
+            if (not own.chunks.empty()) {
+                chunk = own.chunks.front();
+                own.chunks.pop_front();
+                return true;
+            }
+        }
+        for (unsigned k = 1; k < _threads; ++k) {
+            auto & other = _queues[(id + k) % _threads];
+            std::scoped_lock lock{other.mutex};
+            if (not other.chunks.empty()) {
+                chunk = other.chunks.back();
+                other.chunks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(unsigned id)
+    {
+        std::size_t chunk;
+        while (take(id, chunk)) {
+            try {
+                _run(_task, _chunks[chunk]);
+            }
+            catch (...) {
+                std::scoped_lock lock{_error_mutex};
+                if (not _error) {
+                    _error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void serve(unsigned id)
+    {
+        while (true) {
+            _start.arrive_and_wait();
+            if (_stopping) {
+                return;
+            }
+            work(id);
+            _done.arrive_and_wait();
+        }
+    }
+};
+}
@@ -0,0 +1,699 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <optional>
+#include <ostream>
+#include <ios>
+#include <filesystem>
+#include <stdexcept>
+#include <type_traits>
+#include <tuple>
+#include <functional>
+#include <utility>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+#include "hex.hpp"
+#include "grid.hpp"
+#include "mapped_file.hpp"
+
+namespace tess {
+
+/*
+ * Compact binary formats for tiles, readable in place.
+ *
+ * Tile sets and maps store their hexes sorted by row, in blocks of 64. The
+ * first hex of every block is kept in an index, and the rest are written as
+ * variable length deltas from the hex before them, so typical maps take two
+ * bytes per hex. Map values are stored raw after the index, in the same order
+ * as the hexes. Tile grids store a header describing the region followed by
+ * the raw values of every tile.
+ *
+ * Every format is read through a view over the bytes, without unpacking
+ * anything, so a file can be mapped and queried straight away. Values must be
+ * trivially copyable, and are stored in native byte order.
+ */
+
+namespace detail {
+
+struct tile_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t value_size;
+    std::uint64_t count;
+    std::uint64_t blocks;
+};
+
+struct tile_block {
+    std::int32_t q;
+    std::int32_t r;
+    std::uint64_t offset;
+};
+
+struct grid_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t value_size;
+    std::int32_t q;
+    std::int32_t r;
+    std::int32_t width;
+    std::int32_t height;
+};
+
+static_assert(sizeof(tile_header) == 32 and sizeof(tile_block) == 16
+              and sizeof(grid_header) == 32);
+
+inline constexpr std::uint32_t tile_version = 1;
+inline constexpr std::size_t tile_block_size = 64;
+inline constexpr std::size_t tile_alignment = 16;
+
+inline bool row_major_less(hex<int> const & a, hex<int> const & b) noexcept
+{
+    return a.r < b.r or (a.r == b.r and a.q < b.q);
+}
+
+inline std::size_t aligned(std::size_t n) noexcept
+{
+    return (n + tile_alignment - 1) / tile_alignment * tile_alignment;
+}
+
+inline void put_varint(std::vector<std::byte> & bytes, std::uint64_t n)
+{
+    while (n >= 0x80) {
+        bytes.push_back(static_cast<std::byte>(n | 0x80));
+        n >>= 7;
+    }
+    bytes.push_back(static_cast<std::byte>(n));
+}
+
+inline std::uint64_t get_varint(std::byte const *& at, std::byte const * end)
+{
+    std::uint64_t n = 0;
+    for (int shift = 0; at != end and shift < 64; shift += 7) {
+        auto const b = static_cast<std::uint64_t>(*at++);
+        n |= (b & 0x7f) << shift;
+        if (not (b & 0x80)) {
+            return n;
+        }
+    }
+    throw std::invalid_argument{"tile data is truncated"};
+}
+
+inline std::uint64_t zigzag(std::int64_t n) noexcept
+{
+    return (static_cast<std::uint64_t>(n) << 1)
+         ^ static_cast<std::uint64_t>(n >> 63);
+}
+
+inline std::int64_t unzigzag(std::uint64_t n) noexcept
+{
+    return static_cast<std::int64_t>(n >> 1)
+         ^ -static_cast<std::int64_t>(n & 1);
+}
+
+// a hex in the same row is encoded by how far past the last one it is, and a
+// hex in a later row by how many rows down it is and its column delta
+inline void put_delta(std::vector<std::byte> & bytes,
+                      hex<int> const & last, hex<int> const & h)
+{
+    auto const dr = static_cast<std::uint64_t>(
+        static_cast<std::int64_t>(h.r) - last.r);
+    put_varint(bytes, dr);
+    if (dr == 0) {
+        put_varint(bytes, static_cast<std::uint64_t>(
+            static_cast<std::int64_t>(h.q) - last.q - 1));
+    }
+    else {
+        put_varint(bytes, zigzag(static_cast<std::int64_t>(h.q) - last.q));
+    }
+}
+
+inline hex<int> get_delta(std::byte const *& at, std::byte const * end,
+                          hex<int> const & last)
+{
+    auto const dr = get_varint(at, end);
+    auto const dq = get_varint(at, end);
+    if (dr == 0) {
+        return hex<int>{static_cast<int>(last.q + 1 + dq), last.r};
+    }
+    return hex<int>{static_cast<int>(last.q + unzigzag(dq)),
+                    static_cast<int>(last.r + dr)};
+}
+
+inline void write_bytes(std::ostream & out, void const * data,
+                        std::size_t size)
+{
+    out.write(static_cast<char const *>(data),
+              static_cast<std::streamsize>(size));
+    if (not out) {
+        throw std::ios_base::failure{"couldn't write tiles"};
+    }
+}
+
+inline void write_padding(std::ostream & out, std::size_t size)
+{
+    char const zeros[tile_alignment] = {};
+    write_bytes(out, zeros, aligned(size) - size);
+}
+
+// sorted and unique hexes, with values in the same order
+inline void write_tiles(std::ostream & out, char const (&magic)[9],
+                        std::span<hex<int> const> hexes,
+                        void const * values, std::size_t value_size)
+{
+    std::size_t const blocks = (hexes.size() + tile_block_size - 1)
+                             / tile_block_size;
+    std::vector<tile_block> index;
+    index.reserve(blocks);
+    std::vector<std::byte> deltas;
+    for (std::size_t i = 0; i < hexes.size(); ++i) {
+        if (i % tile_block_size == 0) {
+            index.push_back(tile_block{hexes[i].q, hexes[i].r, deltas.size()});
+        }
+        else {
+            put_delta(deltas, hexes[i-1], hexes[i]);
+        }
+    }
+
+    tile_header header{};
+    std::memcpy(header.magic, magic, sizeof(header.magic));
+    header.version = tile_version;
+    header.value_size = static_cast<std::uint32_t>(value_size);
+    header.count = hexes.size();
+    header.blocks = blocks;
+
+    write_bytes(out, &header, sizeof(header));
+    write_bytes(out, index.data(), index.size() * sizeof(tile_block));
+    write_bytes(out, values, hexes.size() * value_size);
+    write_padding(out, hexes.size() * value_size);
+    write_bytes(out, deltas.data(), deltas.size());
+}
+
+// the parsed layout of a tile set or map, pointing into its bytes
+class tile_index {
+public:
+    tile_index() = default;
+
+    tile_index(std::span<std::byte const> bytes, char const (&magic)[9],
+               std::size_t value_size)
+    {
+        if (bytes.size() < sizeof(tile_header)) {
+            throw std::invalid_argument{"tile data is truncated"};
+        }
+        tile_header header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, magic, sizeof(header.magic)) != 0) {
+            throw std::invalid_argument{"tile data has the wrong format"};
+        }
+        if (header.version != tile_version) {
+            throw std::invalid_argument{"tile data has an unknown version"};
+        }
+        if (header.value_size != value_size) {
+            throw std::invalid_argument{"tile data has the wrong value size"};
+        }
+        // the header is untrusted: bound each field by the bytes that are
+        // left before multiplying, so none of the sizes below can wrap
+        std::size_t const rest = bytes.size() - sizeof(tile_header);
+        if (value_size != 0 and header.count > rest / value_size) {
+            throw std::invalid_argument{"tile data is truncated"};
+        }
+        if (header.blocks != header.count / tile_block_size
+                           + (header.count % tile_block_size != 0)) {
+            throw std::invalid_argument{"tile data is corrupt"};
+        }
+        if (header.blocks > rest / sizeof(tile_block)) {
+            throw std::invalid_argument{"tile data is truncated"};
+        }
+
+        _count = header.count;
+        std::size_t const index_bytes = header.blocks * sizeof(tile_block);
+        if (rest - index_bytes < _count * value_size) {
+            throw std::invalid_argument{"tile data is truncated"};
+        }
+        std::size_t const value_bytes = aligned(_count * value_size);
+        if (rest - index_bytes < value_bytes) {
+            throw std::invalid_argument{"tile data is truncated"};
+        }
+        if (reinterpret_cast<std::uintptr_t>(bytes.data()) % tile_alignment) {
+            throw std::invalid_argument{"tile data must be 16 byte aligned"};
+        }
+        _blocks = std::span{reinterpret_cast<tile_block const *>(
+            bytes.data() + sizeof(tile_header)), header.blocks};
+        _values = bytes.data() + sizeof(tile_header) + index_bytes;
+        _deltas = bytes.subspan(sizeof(tile_header) + index_bytes
+                                                     + value_bytes);
+    }
+
+    std::size_t size() const noexcept { return _count; }
+    std::byte const * values() const noexcept { return _values; }
+
+    std::optional<std::size_t> find(hex<int> const & h) const
+    {
+        auto const after = std::upper_bound(
+            _blocks.begin(), _blocks.end(), h,
+            [](hex<int> const & h, tile_block const & block) {
+                return row_major_less(h, hex<int>{block.q, block.r});
+            });
+        if (after == _blocks.begin()) {
+            return std::nullopt;
+        }
+        auto const b = static_cast<std::size_t>(after - _blocks.begin()) - 1;
+        std::optional<std::size_t> found;
+        scan_block(b, [&](std::size_t i, hex<int> const & tile) {
+            if (tile == h) {
+                found = i;
+            }
+            return row_major_less(tile, h);
+        });
+        return found;
+    }
+
+    template<typename F>
+    void for_each(F && f) const
+    {
+        for (std::size_t b = 0; b < _blocks.size(); ++b) {
+            scan_block(b, [&](std::size_t i, hex<int> const & tile) {
+                f(i, tile);
+                return true;
+            });
+        }
+    }
+
+private:
+    std::size_t _count = 0;
+    std::span<tile_block const> _blocks;
+    std::byte const * _values = nullptr;
+    std::span<std::byte const> _deltas;
+
+    // visit the hexes of block `b` while `f` returns true
+    template<typename F>
+    void scan_block(std::size_t b, F && f) const
+    {
+        auto const & block = _blocks[b];
+        if (block.offset > _deltas.size()) {
+            throw std::invalid_argument{"tile data is corrupt"};
+        }
+        std::byte const * at = _deltas.data() + block.offset;
+        std::byte const * const end = _deltas.data() + _deltas.size();
+
+        std::size_t const first = b * tile_block_size;
+        std::size_t const last = std::min(_count, first + tile_block_size);
+        hex<int> tile{block.q, block.r};
+        for (std::size_t i = first; i < last; ++i) {
+            if (i != first) {
+                tile = get_delta(at, end, tile);
+            }
+            if (not f(i, tile)) {
+                return;
+            }
+        }
+    }
+};
+
+inline constexpr char tile_set_magic[9] = "TESS_SET";
+inline constexpr char tile_map_magic[9] = "TESS_MAP";
+inline constexpr char tile_grid_magic[9] = "TESSGRID";
+}
+
+/**
+ * Write every hex of `hexes` to `out` as a tile set.
+ *
+ * Duplicate hexes are only written once. `out` should be opened in binary
+ * mode.
+ *
+ * \code{.cpp}
+ * std::ofstream file{"explored.tiles", std::ios::binary};
+ * save_tile_set(file, explored);
+ * \endcode
+ *
+ * \throws std::ios_base::failure if `out` can't be written to.
+ */
+template<std::ranges::input_range Hexes>
+requires std::convertible_to<std::ranges::range_value_t<Hexes>, hex<int>>
+void save_tile_set(std::ostream & out, Hexes const & hexes)
+{
+    std::vector<hex<int>> sorted;
+    for (hex<int> const h : hexes) {
+        sorted.push_back(h);
+    }
+    std::ranges::sort(sorted, detail::row_major_less);
+    auto const repeats = std::ranges::unique(sorted);
+    sorted.erase(repeats.begin(), repeats.end());
+    detail::write_tiles(out, detail::tile_set_magic, sorted, nullptr, 0);
+}
+
+/**
+ * Write every `(hex, value)` element of `tiles` to `out` as a tile map.
+ *
+ * If a hex appears more than once only its first value is written. `out`
+ * should be opened in binary mode.
+ *
+ * \code{.cpp}
+ * std::unordered_map<hex<int>, float> fertility = ...;
+ * std::ofstream file{"fertility.tiles", std::ios::binary};
+ * save_tile_map(file, fertility);
+ * \endcode
+ *
+ * \throws std::ios_base::failure if `out` can't be written to.
+ */
+template<std::ranges::input_range Tiles>
+void save_tile_map(std::ostream & out, Tiles const & tiles)
+{
+    using Element = std::ranges::range_value_t<Tiles>;
+    using T = std::remove_cvref_t<std::tuple_element_t<1, Element>>;
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "tile values must be trivially copyable");
+    static_assert(alignof(T) <= detail::tile_alignment,
+                  "tile values must be at most 16 byte aligned");
+
+    std::vector<std::pair<hex<int>, T>> sorted;
+    for (auto const & [h, value] : tiles) {
+        sorted.emplace_back(h, value);
+    }
+    std::ranges::stable_sort(sorted, detail::row_major_less,
+                             [](auto const & tile) { return tile.first; });
+    auto const repeats = std::ranges::unique(sorted, std::equal_to<>{},
+        [](auto const & tile) { return tile.first; });
+    sorted.erase(repeats.begin(), repeats.end());
+
+    std::vector<hex<int>> hexes;
+    std::vector<T> values;
+    hexes.reserve(sorted.size());
+    values.reserve(sorted.size());
+    for (auto const & [h, value] : sorted) {
+        hexes.push_back(h);
+        values.push_back(value);
+    }
+    detail::write_tiles(out, detail::tile_map_magic, hexes,
+                        values.data(), sizeof(T));
+}
+
+/**
+ * Write the region and every tile of `grid` to `out` as a tile grid.
+ *
+ * \throws std::ios_base::failure if `out` can't be written to.
+ */
+template<typename T>
+void save_tile_grid(std::ostream & out, hex_grid<T> const & grid)
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "tile values must be trivially copyable");
+    static_assert(alignof(T) <= detail::tile_alignment,
+                  "tile values must be at most 16 byte aligned");
+
+    detail::grid_header header{};
+    std::memcpy(header.magic, detail::tile_grid_magic, sizeof(header.magic));
+    header.version = detail::tile_version;
+    header.value_size = sizeof(T);
+    header.q = grid.origin().q;
+    header.r = grid.origin().r;
+    header.width = grid.width();
+    header.height = grid.height();
+    detail::write_bytes(out, &header, sizeof(header));
+    detail::write_bytes(out, grid.data(), grid.size() * sizeof(T));
+}
+
+/**
+ * A read-only view of a tile set written by `save_tile_set`.
+ *
+ * Finding a hex searches the block index, then decodes at most one block.
+ * The view doesn't own its bytes, which must outlive it.
+ */
+class tile_set_view {
+public:
+    /** An empty set. */
+    tile_set_view() = default;
+
+    /**
+     * View the tile set stored in `bytes`.
+     *
+     * \throws std::invalid_argument if `bytes` doesn't hold a tile set or
+     *         isn't 16 byte aligned.
+     */
+    explicit tile_set_view(std::span<std::byte const> bytes)
+
+        : _index{bytes, detail::tile_set_magic, 0}
+    {
+    }
+
+    /** The number of hexes in this set. */
+    std::size_t size() const noexcept { return _index.size(); }
+
+    /** Determine if `h` is in this set. */
+    bool contains(hex<int> const & h) const
+    {
+        return _index.find(h).has_value();
+    }
+
+    /** Call `f(h)` for every hex of this set, in row-major order. */
+    template<typename F>
+    void for_each(F && f) const
+    {
+        _index.for_each([&f](std::size_t, hex<int> const & h) { f(h); });
+    }
+
+private:
+    detail::tile_index _index;
+};
+
+/**
+ * A read-only view of a tile map written by `save_tile_map`.
+ *
+ * \code{.cpp}
+ * mapped_tiles<tile_map_view<float>> const fertility{"fertility.tiles"};
+ * if (auto const * value = fertility->find(h)) { ... }
+ * \endcode
+ */
+template<typename T>
+class tile_map_view {
+public:
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "tile values must be trivially copyable");
+
+    /** An empty map. */
+    tile_map_view() = default;
+
+    /**
+     * View the tile map stored in `bytes`.
+     *
+     * \throws std::invalid_argument if `bytes` doesn't hold a tile map of
+     *         `T` or isn't 16 byte aligned.
+     */
+    explicit tile_map_view(std::span<std::byte const> bytes)
+
+        : _index{bytes, detail::tile_map_magic, sizeof(T)}
+    {
+    }
+
+    /** The number of tiles in this map. */
+    std::size_t size() const noexcept { return _index.size(); }
+
+    /** Every value of this map, in the row-major order of their hexes. */
+    std::span<T const> values() const noexcept
+    {
+        return {reinterpret_cast<T const *>(_index.values()), _index.size()};
+    }
+
+    /** Determine if `h` is in this map. */
+    bool contains(hex<int> const & h) const
+    {
+        return _index.find(h).has_value();
+    }
+
+    /** The value of `h`, or null if `h` isn't in this map. */
+    T const * find(hex<int> const & h) const
+    {
+        auto const i = _index.find(h);
+        return i? values().data() + *i : nullptr;
+    }
+
+    /**
+     * The value of `h`.
+     *
+     * \throws std::out_of_range if `h` isn't in this map.
+     */
+    T const & at(hex<int> const & h) const
+    {
+        if (auto const * value = find(h)) {
+            return *value;
+        }
+        throw std::out_of_range{"hex is not in the tile map"};
+    }
+
+    /** Call `f(h, value)` for every tile of this map, in row-major order. */
+    template<typename F>
+    void for_each(F && f) const
+    {
+        auto const all = values();
+        _index.for_each([&](std::size_t i, hex<int> const & h) {
+            f(h, all[i]);
+        });
+    }
+
+private:
+    detail::tile_index _index;
+};
+
+/**
+ * A read-only view of a tile grid written by `save_tile_grid`.
+ *
+ * Tiles are laid out exactly as in `hex_grid`, so rows can be read in bulk.
+ */
+template<typename T>
+class tile_grid_view {
+public:
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "tile values must be trivially copyable");
+
+    /** An empty grid. */
+    tile_grid_view() = default;
+
+    /**
+     * View the tile grid stored in `bytes`.
+     *
+     * \throws std::invalid_argument if `bytes` doesn't hold a tile grid of
+     *         `T` or isn't aligned for `T`.
+     */
+    explicit tile_grid_view(std::span<std::byte const> bytes)
+    {
+        if (bytes.size() < sizeof(detail::grid_header)) {
+            throw std::invalid_argument{"tile data is truncated"};
+        }
+        detail::grid_header header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, detail::tile_grid_magic,
+                        sizeof(header.magic)) != 0) {
+            throw std::invalid_argument{"tile data has the wrong format"};
+        }
+        if (header.version != detail::tile_version) {
+            throw std::invalid_argument{"tile data has an unknown version"};
+        }
+        if (header.value_size != sizeof(T)) {
+            throw std::invalid_argument{"tile data has the wrong value size"};
+        }
+        if (header.width < 0 or header.height < 0) {
+            throw std::invalid_argument{"tile data is corrupt"};
+        }
+        // the header is untrusted: bound the tile count by the bytes that
+        // are left rather than multiplying it out, which could wrap
+        auto const count = static_cast<std::size_t>(header.width)
+                         * static_cast<std::size_t>(header.height);
+        if (count > (bytes.size() - sizeof(header)) / sizeof(T)) {
+            throw std::invalid_argument{"tile data is truncated"};
+        }
+        std::byte const * const data = bytes.data() + sizeof(header);
+        if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0) {
+            throw std::invalid_argument{"tile data isn't aligned"};
+        }
+        _origin = hex<int>{header.q, header.r};
+        _width = header.width;
+        _height = header.height;
+        _tiles = std::span{reinterpret_cast<T const *>(data), count};
+    }
+
+    /** The hex of the first tile of this grid. */
+    hex<int> origin() const noexcept { return _origin; }
+
+    /** The number of tiles in each row of this grid. */
+    int width() const noexcept { return _width; }
+
+    /** The number of rows in this grid. */
+    int height() const noexcept { return _height; }
+
+    /** The number of tiles in this grid. */
+    std::size_t size() const noexcept { return _tiles.size(); }
+
+    /** Determine if `h` lies within the bounds of this grid. */
+    bool contains(hex<int> const & h) const noexcept
+    {
+        int const q = h.q - _origin.q;
+        int const r = h.r - _origin.r;
+        return 0 <= q and q < _width and 0 <= r and r < _height;
+    }
+
+    /** The tile at `h`, which must lie within the bounds of this grid. */
+    T const & operator[](hex<int> const & h) const noexcept
+    {
+        auto const q = static_cast<std::size_t>(h.q - _origin.q);
+        auto const r = static_cast<std::size_t>(h.r - _origin.r);
+        return _tiles[r*static_cast<std::size_t>(_width) + q];
+    }
+
+    /**
+     * The tile at `h`.
+     *
+     * \throws std::out_of_range if `h` isn't within the bounds of this grid.
+     */
+    T const & at(hex<int> const & h) const
+    {
+        if (not contains(h)) {
+            throw std::out_of_range{"hex is outside of the grid"};
+        }
+        return (*this)[h];
+    }
+
+    /** The `i`th row of this grid, counting from the origin. */
+    std::span<T const> row(int i) const noexcept
+    {
+        return _tiles.subspan(static_cast<std::size_t>(i)*_width, _width);
+    }
+
+    /** Every tile of this grid, row by row. */
+    std::span<T const> tiles() const noexcept { return _tiles; }
+
+    /** Copy every tile into a new grid. */
+    hex_grid<T> load() const
+    {
+        hex_grid<T> grid{_origin, _width, _height};
+        std::copy(_tiles.begin(), _tiles.end(), grid.data());
+        return grid;
+    }
+
+private:
+    hex<int> _origin = hex<int>::zero;
+    int _width = 0;
+    int _height = 0;
+    std::span<T const> _tiles;
+};
+
+/**
+ * A tile view over a whole file, mapped into memory.
+ *
+ * `View` is one of `tile_set_view`, `tile_map_view` or `tile_grid_view`, and
+ * is reached through `*` and `->`. Only the pages that queries touch are read
+ * from disk.
+ *
+ * \code{.cpp}
+ * mapped_tiles<tile_grid_view<std::uint16_t>> const terrain{"terrain.tiles"};
+ * auto const height = terrain->at(h);
+ * \endcode
+ */
+template<typename View>
+class mapped_tiles {
+public:
+    /**
+     * Map the file at `path` and view it.
+     *
+     * \throws std::system_error if the file can't be opened or mapped.
+     * \throws std::invalid_argument if the file doesn't hold tiles that
+     *         `View` can read.
+     */
+    explicit mapped_tiles(std::filesystem::path const & path)
+
+        : _file{path}, _view{_file.map()}
+    {
+    }
+
+    View const & operator*() const noexcept { return _view; }
+    View const * operator->() const noexcept { return &_view; }
+
+private:
+    mapped_file _file;
+    View _view;
+};
+}
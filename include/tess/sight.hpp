@@ -0,0 +1,79 @@
+#pragma once
+
+#include <concepts>
+#include <iterator>
+#include <cstdint>
+
+#include "math.hpp"
+#include "hex.hpp"
+
+namespace tess {
+
+/**
+ * Determine if `b` can be seen from `a`.
+ *
+ * The hexes between `a` and `b` are visited in the same order that `line`
+ * would produce them, but are never stored. The walk stops at the first hex
+ * for which `is_opaque` holds. The endpoints themselves never block sight, so
+ * an opaque wall is visible from its neighbors.
+ */
+template<axial Hex, std::predicate<Hex const &> Opaque>
+requires std::integral<scalar_field_t<Hex>>
+bool line_of_sight(Hex const & a, Hex const & b, Opaque && is_opaque)
+{
+    using Integer = scalar_field_t<Hex>;
+    auto lerp = [](double a, double b, double t) {
+        return a + (b - a) * t;
+    };
+
+    Integer const n = hex_norm(a-b);
+    for (int i = 1; i < n; i++) {
+        double const t = i/(double)n;
+        auto const h = hex_round<Integer>(hex{ lerp(a.q, b.q, t),
+                                               lerp(a.r, b.r, t) });
+        if (is_opaque(Hex{h.q, h.r})) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Determine which of many segments are unobstructed.
+ *
+ * Each element of `[first, last)` is a pair-like `(from, to)` of hexes. The
+ * result of `line_of_sight` for the `i`th segment is written to bit `i % 64`
+ * of the `i / 64`th word of `into_mask`. A trailing partial word is padded
+ * with zeros.
+ *
+ * \code{.cpp}
+ * std::vector<std::pair<hex<int>, hex<int>>> shots = ...;
+ * std::vector<std::uint64_t> visible;
+ * lines_of_sight(shots.begin(), shots.end(), is_wall,
+ *                std::back_inserter(visible));
+ * \endcode
+ */
+template<std::input_iterator It, typename Opaque,
+         std::indirectly_writable<std::uint64_t> Out>
+requires std::weakly_incrementable<Out>
+auto lines_of_sight(It first, It last, Opaque && is_opaque, Out into_mask)
+{
+    std::uint64_t word = 0;
+    int bit = 0;
+    for (; first != last; ++first) {
+        auto const & [a, b] = *first;
+        if (line_of_sight(a, b, is_opaque)) {
+            word |= std::uint64_t{1} << bit;
+        }
+        if (++bit == 64) {
+            *into_mask++ = word;
+            word = 0;
+            bit = 0;
+        }
+    }
+    if (bit != 0) {
+        *into_mask++ = word;
+    }
+    return into_mask;
+}
+}
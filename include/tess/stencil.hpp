@@ -0,0 +1,230 @@
+#pragma once
+
+#include <concepts>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+
+#include "hex.hpp"
+#include "grid.hpp"
+#include "parallel.hpp"
+
+namespace tess {
+
+/**
+ * Weights over every hex within `radius` of a center tile.
+ *
+ * Weights are ordered like the hexes `hex_range` generates around the zero
+ * hex, and `offsets()` gives the hex each one applies to.
+ *
+ * \code{.cpp}
+ * // blur each tile with its neighbors
+ * hex_kernel<float> const blur{1, [](hex<int> const & offset) {
+ *     return offset == hex<int>::zero? 0.4f : 0.1f;
+ * }};
+ * \endcode
+ */
+template<typename Weight>
+class hex_kernel {
+public:
+    /**
+     * Create a kernel of `radius` with `weights` in `hex_range` order.
+     *
+     * \throws std::invalid_argument if `radius` is negative or there isn't
+     *         exactly one weight per hex in the range.
+     */
+    hex_kernel(int radius, std::vector<Weight> weights)
+
+        : _radius{radius}, _weights{std::move(weights)}
+    {
+        if (radius < 0) {
+            throw std::invalid_argument{"kernel radius must not be negative"};
+        }
+        hex_range(hex<int>::zero, radius, std::back_inserter(_offsets));
+        if (_weights.size() != _offsets.size()) {
+            throw std::invalid_argument{
+                "kernel must have one weight per hex in its range"};
+        }
+    }
+
+    /**
+     * Create a kernel of `radius`, calling `weight(offset)` for the weight of
+     * each hex offset from the center.
+     *
+     * \throws std::invalid_argument if `radius` is negative.
+     */
+    template<typename F>
+    requires std::convertible_to<std::invoke_result_t<F &, hex<int> const &>,
+                                 Weight>
+    hex_kernel(int radius, F && weight)
+
+        : hex_kernel{radius, weights_of(radius, weight)}
+    {
+    }
+
+    /** The distance from the center to the furthest weighted hex. */
+    int radius() const noexcept { return _radius; }
+
+    /** The weight of each hex, in `hex_range` order. */
+    std::span<Weight const> weights() const noexcept { return _weights; }
+
+    /** The offset from the center of each weighted hex. */
+    std::span<hex<int> const> offsets() const noexcept { return _offsets; }
+
+private:
+    int _radius;
+    std::vector<Weight> _weights;
+    std::vector<hex<int>> _offsets;
+
+    template<typename F>
+    static std::vector<Weight> weights_of(int radius, F & weight)
+    {
+        std::vector<hex<int>> offsets;
+        if (radius >= 0) {
+            hex_range(hex<int>::zero, radius, std::back_inserter(offsets));
+        }
+        std::vector<Weight> weights;
+        weights.reserve(offsets.size());
+        for (auto const & offset : offsets) {
+            weights.push_back(static_cast<Weight>(weight(offset)));
+        }
+        return weights;
+    }
+};
+
+/**
+ * A radius one kernel that spreads `rate` of each tile evenly between its
+ * neighbors and keeps the rest.
+ */
+template<std::floating_point Weight>
+hex_kernel<Weight> diffusion_kernel(Weight rate)
+{
+    return hex_kernel<Weight>{1, [rate](hex<int> const & offset) {
+        return offset == hex<int>::zero? 1 - rate : rate / 6;
+    }};
+}
+
+/**
+ * Write the weighted sum of the neighborhood of every tile of `from` into the
+ * matching tile of `into`.
+ *
+ * Each tile becomes the sum of `kernel`'s weights times the tiles at its
+ * offsets. Tiles beyond the bounds of the grid count as zero. Rows are split
+ * between threads, and the columns far enough from the sides of the grid are
+ * summed a whole row and a whole weight at a time, over contiguous memory, so
+ * the inner loop is a plain multiply-add that compilers vectorize.
+ *
+ * \code{.cpp}
+ * auto const spread = diffusion_kernel(0.2f);
+ * hex_grid<float> next{heat.origin(), heat.width(), heat.height()};
+ * for (int tick = 0; tick < ticks; ++tick) {
+ *     apply_stencil(heat, spread, next);
+ *     std::swap(heat, next);
+ * }
+ * \endcode
+ *
+ * \throws std::invalid_argument if `into` doesn't cover the same region as
+ *         `from`, or if they're the same grid.
+ */
+template<typename T, typename Weight>
+void apply_stencil(hex_grid<T> const & from, hex_kernel<Weight> const & kernel,
+                   hex_grid<T> & into, unsigned threads = default_threads())
+{
+    if (from.origin() != into.origin() or from.width() != into.width()
+                                       or from.height() != into.height()) {
+        throw std::invalid_argument{
+            "stencil input and output must cover the same region"};
+    }
+    if (&from == &into) {
+        throw std::invalid_argument{
+            "stencil input and output must be different grids"};
+    }
+
+    int const width = from.width();
+    int const height = from.height();
+    int const k = kernel.radius();
+    auto const weights = kernel.weights();
+    auto const offsets = kernel.offsets();
+
+    // each weight reads the tile a fixed distance away in memory
+    std::vector<std::ptrdiff_t> flat;
+    flat.reserve(offsets.size());
+    for (auto const & d : offsets) {
+        flat.push_back(static_cast<std::ptrdiff_t>(d.r) * width + d.q);
+    }
+
+    // columns in [k, width-k) never read past the sides of a row
+    int const inner_first = std::min(k, width);
+    int const inner_last = std::max(inner_first, width - k);
+
+    auto const sum_tile = [&](int q, int r) {
+        T total{};
+        for (std::size_t t = 0; t < offsets.size(); ++t) {
+            int const nq = q + offsets[t].q;
+            int const nr = r + offsets[t].r;
+            if (0 <= nq and nq < width and 0 <= nr and nr < height) {
+                total += weights[t] * from.data()[
+                    static_cast<std::size_t>(nr) * width + nq];
+            }
+        }
+        return total;
+    };
+
+    parallel_for(static_cast<std::size_t>(height), threads,
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            for (auto row = first; row < last; ++row) {
+                int const r = static_cast<int>(row);
+                int const inner = inner_last - inner_first;
+
+                // only form pointers into the row when the inner span has
+                // tiles: narrow rows would otherwise point outside the grid
+                if (inner > 0) {
+                    T * const out = into.row(r).data() + inner_first;
+                    std::ptrdiff_t const at = static_cast<std::ptrdiff_t>(r)
+                                            * width + inner_first;
+
+                    std::fill(out, out + inner, T{});
+                    for (std::size_t t = 0; t < offsets.size(); ++t) {
+                        int const nr = r + offsets[t].r;
+                        if (nr < 0 or nr >= height) {
+                            continue;
+                        }
+                        Weight const w = weights[t];
+                        T const * const source = from.data() + (at + flat[t]);
+                        for (int i = 0; i < inner; ++i) {
+                            out[i] += w * source[i];
+                        }
+                    }
+                }
+
+                auto const edges = into.row(r);
+                for (int q = 0; q < inner_first; ++q) {
+                    edges[q] = sum_tile(q, r);
+                }
+                for (int q = inner_last; q < width; ++q) {
+                    edges[q] = sum_tile(q, r);
+                }
+            }
+        });
+}
+
+/**
+ * Calculate the weighted sum of the neighborhood of every tile of `from`.
+ *
+ * \see apply_stencil
+ */
+template<typename T, typename Weight>
+hex_grid<T> apply_stencil(hex_grid<T> const & from,
+                          hex_kernel<Weight> const & kernel,
+                          unsigned threads = default_threads())
+{
+    hex_grid<T> into{from.origin(), from.width(), from.height()};
+    apply_stencil(from, kernel, into, threads);
+    return into;
+}
+}
@@ -3,3 +3,27 @@
 #include "point.hpp"
 #include "hex.hpp"
 #include "basis.hpp"
+#include "grid.hpp"
+#include "distance.hpp"
+#include "sight.hpp"
+#include "mesh.hpp"
+#include "outline.hpp"
+#include "raster.hpp"
+#include "offset.hpp"
+#include "parallel.hpp"
+#include "mapped_file.hpp"
+#include "hexbin.hpp"
+#include "hierarchy.hpp"
+#include "automaton.hpp"
+#include "stencil.hpp"
+#include "serialize.hpp"
+#include "hex_set.hpp"
+#include "concurrent_map.hpp"
+#include "scheduler.hpp"
+#include "topology.hpp"
+#include "pattern.hpp"
+#include "hex_soa.hpp"
+#include "ray.hpp"
+#include "nearest.hpp"
+#include "voronoi.hpp"
+#include "noise.hpp"
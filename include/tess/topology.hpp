@@ -0,0 +1,229 @@
+#pragma once
+
+#include <concepts>
+#include <iterator>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cstddef>
+
+#include "hex.hpp"
+
+namespace tess {
+
+enum class HexWrap { Cylinder, Torus };
+
+/**
+ * A region of hexes whose edges wrap around onto each other.
+ *
+ * The region is the same `width` by `height` parallelogram a `hex_grid`
+ * covers. A cylinder wraps its east and west edges together, so `h` and
+ * `h + hex<int>{width, 0}` are the same tile; a torus also wraps its north
+ * and south edges, so `h + hex<int>{0, height}` is the same tile as well.
+ * `wrap` gives the copy of any hex that lies in the region, so results can be
+ * used to index a `hex_grid` over the same region.
+ *
+ * Distances, lines and ranges take the shortest way around. Wrapping looks up
+ * a table of each column (and row) one period either side of the region, so
+ * the usual case of a hex just past an edge costs no division.
+ *
+ * \code{.cpp}
+ * hex_cylinder const world{hex<int>::zero, 360, 180};
+ * hex_grid<terrain> tiles{world.origin(), world.width(), world.height()};
+ * for (auto const & h : path) {
+ *     auto const & tile = tiles[world.wrap(h)];
+ * }
+ * \endcode
+ */
+template<HexWrap WrapStyle>
+class hex_topology {
+public:
+    /**
+     * Create a wrapping `width` by `height` region at `origin`.
+     *
+     * \throws std::invalid_argument if `width` or `height` isn't positive.
+     */
+    hex_topology(hex<int> const & origin, int width, int height)
+
+        : _origin{origin}, _width{width}, _height{height}
+    {
+        if (width <= 0 or height <= 0) {
+            throw std::invalid_argument{
+                "hex_topology dimensions must be positive"};
+        }
+        _columns = wrap_table(width);
+        if constexpr (WrapStyle == HexWrap::Torus) {
+            _rows = wrap_table(height);
+        }
+    }
+
+    /** The hex of the first tile of the region. */
+    hex<int> origin() const noexcept { return _origin; }
+
+    /** The number of tiles in each row of the region. */
+    int width() const noexcept { return _width; }
+
+    /** The number of rows in the region. */
+    int height() const noexcept { return _height; }
+
+    /**
+     * Determine if `h` is a tile of this topology.
+     *
+     * Every hex is a tile of a torus, while a cylinder only has the rows
+     * between its north and south edges.
+     */
+    bool contains(hex<int> const & h) const noexcept
+    {
+        if constexpr (WrapStyle == HexWrap::Torus) {
+            return true;
+        }
+        int const r = h.r - _origin.r;
+        return 0 <= r and r < _height;
+    }
+
+    /** The copy of `h` that lies within the region. */
+    hex<int> wrap(hex<int> const & h) const noexcept
+    {
+        int const q = wrap_local(_columns, h.q - _origin.q, _width);
+        int r = h.r - _origin.r;
+        if constexpr (WrapStyle == HexWrap::Torus) {
+            r = wrap_local(_rows, r, _height);
+        }
+        return _origin + hex<int>{q, r};
+    }
+
+    /** The tile `offset` away from `h`, wrapped into the region. */
+    hex<int> offset(hex<int> const & h, hex<int> const & offset) const noexcept
+    {
+        return wrap(h + offset);
+    }
+
+    /** The copy of `b` closest to `a`, which may lie outside of the region. */
+    hex<int> nearest(hex<int> const & a, hex<int> const & b) const noexcept
+    {
+        // with each wrapping component of the difference in [0, period),
+        // the shortest way is either straight there or once around in the
+        // negative direction of each wrapping axis
+        auto d = wrap(b) - wrap(a);
+        d.q += d.q < 0? _width : 0;
+        if constexpr (WrapStyle == HexWrap::Torus) {
+            d.r += d.r < 0? _height : 0;
+        }
+        hex<int> best = d;
+        int shortest = hex_norm(d);
+        auto const consider = [&](hex<int> const & candidate) {
+            int const n = hex_norm(candidate);
+            if (n < shortest) {
+                best = candidate;
+                shortest = n;
+            }
+        };
+        int const qs[2] = {d.q, d.q - _width};
+        for (int const q : qs) {
+            consider(hex<int>{q, d.r});
+            if constexpr (WrapStyle == HexWrap::Torus) {
+                consider(hex<int>{q, d.r - _height});
+            }
+        }
+        return a + best;
+    }
+
+    /** Calculate the length of the shortest way from `a` to `b`. */
+    int distance(hex<int> const & a, hex<int> const & b) const noexcept
+    {
+        return hex_norm(nearest(a, b) - a);
+    }
+
+    /**
+     * Calculate the hexes in the shortest line from `a` to `b`, each wrapped
+     * into the region.
+     */
+    template<std::indirectly_writable<hex<int>> Out>
+    requires std::weakly_incrementable<Out>
+    auto line(hex<int> const & a, hex<int> const & b, Out into_hexes) const
+    {
+        std::vector<hex<int>> hexes;
+        tess::line(a, nearest(a, b), std::back_inserter(hexes));
+        for (auto const & h : hexes) {
+            *into_hexes++ = wrap(h);
+        }
+        return into_hexes;
+    }
+
+    /**
+     * Calculate the tiles within `radius` of `center`, each wrapped into the
+     * region and written once.
+     *
+     * On a cylinder, rows past the north and south edges are left out.
+     */
+    template<std::indirectly_writable<hex<int>> Out>
+    requires std::weakly_incrementable<Out>
+    auto range(hex<int> const & center, int radius, Out into_hexes) const
+    {
+        bool const overlaps = 2*radius + 1 > _width
+            or (WrapStyle == HexWrap::Torus and 2*radius + 1 > _height);
+        if (not overlaps) {
+            for (int i = -radius; i <= radius; ++i) {
+                for (int j = std::max(-radius, -radius-i);
+                         j <= std::min(radius, radius-i); ++j) {
+                    auto const h = center + hex<int>{i, j};
+                    if (contains(h)) {
+                        *into_hexes++ = wrap(h);
+                    }
+                }
+            }
+            return into_hexes;
+        }
+
+        // the range wraps onto itself, so test each tile of the region once
+        int first = 0;
+        int last = _height;
+        if constexpr (WrapStyle == HexWrap::Cylinder) {
+            first = std::max(0, center.r - _origin.r - radius);
+            last = std::min(_height, center.r - _origin.r + radius + 1);
+        }
+        for (int r = first; r < last; ++r) {
+            for (int q = 0; q < _width; ++q) {
+                auto const h = _origin + hex<int>{q, r};
+                if (distance(center, h) <= radius) {
+                    *into_hexes++ = h;
+                }
+            }
+        }
+        return into_hexes;
+    }
+
+private:
+    hex<int> _origin;
+    int _width;
+    int _height;
+    std::vector<int> _columns;
+    std::vector<int> _rows;
+
+    // the wrapped position of every offset in [-n, 2n)
+    static std::vector<int> wrap_table(int n)
+    {
+        std::vector<int> table(3 * static_cast<std::size_t>(n));
+        for (int i = 0; i < 3*n; ++i) {
+            table[i] = i % n;
+        }
+        return table;
+    }
+
+    static int wrap_local(std::vector<int> const & table, int x, int n)
+        noexcept
+    {
+        if (-n <= x and x < 2*n) {
+            return table[x + n];
+        }
+        int const m = x % n;
+        return m < 0? m + n : m;
+    }
+};
+
+/** A region that wraps east to west. */
+using hex_cylinder = hex_topology<HexWrap::Cylinder>;
+
+/** A region that wraps east to west and north to south. */
+using hex_torus = hex_topology<HexWrap::Torus>;
+}
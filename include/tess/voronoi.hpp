@@ -0,0 +1,266 @@
+#pragma once
+
+#include <concepts>
+#include <ranges>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <atomic>
+#include <barrier>
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+
+#include "hex.hpp"
+#include "grid.hpp"
+#include "parallel.hpp"
+
+namespace tess {
+
+/** The seed of a tile that no seed can reach. */
+inline constexpr std::uint32_t no_seed =
+    std::numeric_limits<std::uint32_t>::max();
+
+/**
+ * The tiles of a region, each assigned to its nearest seed.
+ *
+ * `seed[h]` is the index of the seed nearest to `h`, or `no_seed` if no seed
+ * can reach it, and `distance[h]` is how far away that seed is, or the
+ * largest `Distance` if there is none.
+ */
+template<typename Distance>
+struct voronoi_partition {
+    hex_grid<std::uint32_t> seed;
+    hex_grid<Distance> distance;
+};
+
+namespace detail {
+
+// call `f(j)` with the flat index of each neighbor of tile `i` in the grid
+template<typename F>
+void for_each_neighbor(std::size_t i, int width, int height, F && f)
+{
+    int const q = static_cast<int>(i % width);
+    int const r = static_cast<int>(i / width);
+    std::size_t const w = static_cast<std::size_t>(width);
+    if (q+1 < width) {
+        f(i + 1);
+        if (r > 0) f(i - w + 1);
+    }
+    if (r > 0) f(i - w);
+    if (q > 0) {
+        f(i - 1);
+        if (r+1 < height) f(i + w - 1);
+    }
+    if (r+1 < height) f(i + w);
+}
+
+template<typename Distance, typename Seeds>
+voronoi_partition<Distance>
+place_seeds(hex<int> const & origin, int width, int height,
+            Seeds const & seeds, std::vector<std::uint32_t> & frontier)
+{
+    voronoi_partition<Distance> cells{
+        hex_grid<std::uint32_t>{origin, width, height, no_seed},
+        hex_grid<Distance>{origin, width, height,
+                           std::numeric_limits<Distance>::max()}
+    };
+    std::uint32_t id = 0;
+    for (hex<int> const h : seeds) {
+        if (not cells.seed.contains(h)) {
+            throw std::out_of_range{"voronoi seeds must lie in the region"};
+        }
+        auto const i = cells.seed.index(h);
+        if (cells.seed.data()[i] == no_seed) {
+            cells.seed.data()[i] = id;
+            cells.distance.data()[i] = Distance{0};
+            frontier.push_back(static_cast<std::uint32_t>(i));
+        }
+        ++id;
+    }
+    return cells;
+}
+}
+
+/**
+ * Assign every tile of the `width` by `height` region at `origin` to its
+ * nearest seed, on `threads` threads.
+ *
+ * Seeds are referred to by their index in `seeds`. Distances are hex
+ * distances, and a tile the same distance from several seeds goes to the
+ * seed with the lowest index.
+ *
+ * The partition grows out from every seed at once, one ring of tiles at a
+ * time. The tiles of each ring are split between the threads, and each tile
+ * of the next ring is claimed with one compare-and-swap and takes the lowest
+ * seed of its neighbors in the current ring. Threads are started once
+ * and meet at a barrier between rings, so the cost of a ring is proportional
+ * to its number of tiles.
+ *
+ * \code{.cpp}
+ * auto const counties = voronoi(map.origin(), map.width(), map.height(),
+ *                               capitals);
+ * if (counties.seed[tile] != counties.seed[neighbor]) {
+ *     draw_border(tile, neighbor);
+ * }
+ * \endcode
+ *
+ * \throws std::invalid_argument if `width` or `height` is negative.
+ * \throws std::out_of_range if a seed lies outside of the region.
+ */
+template<std::ranges::input_range Seeds>
+requires std::convertible_to<std::ranges::range_reference_t<Seeds>, hex<int>>
+voronoi_partition<int>
+voronoi(hex<int> const & origin, int width, int height, Seeds const & seeds,
+        unsigned threads = default_threads())
+{
+    if (width < 0 or height < 0) {
+        throw std::invalid_argument{"voronoi dimensions must not be negative"};
+    }
+    std::size_t const n = static_cast<std::size_t>(width) * height;
+    std::vector<std::uint32_t> frontier;
+    frontier.reserve(n);
+    auto cells = detail::place_seeds<int>(origin, width, height, seeds,
+                                          frontier);
+    std::size_t current_size = frontier.size();
+    frontier.resize(n);
+    std::vector<std::uint32_t> next(n);
+
+    std::uint32_t * const owners = cells.seed.data();
+    int * const distances = cells.distance.data();
+    int const unreached = std::numeric_limits<int>::max();
+
+    // the current ring and the next one swap once every thread has finished
+    std::uint32_t * current = frontier.data();
+    std::uint32_t * upcoming = next.data();
+    std::atomic<std::size_t> upcoming_size = 0;
+    int level = 0;
+
+    unsigned const bands = static_cast<unsigned>(std::max<std::size_t>(
+        1, std::min<std::size_t>(threads, n)));
+    auto const advance = [&]() noexcept {
+        std::swap(current, upcoming);
+        current_size = upcoming_size.exchange(0);
+        ++level;
+    };
+    std::barrier sync{static_cast<std::ptrdiff_t>(bands), advance};
+
+    auto const grow = [&](unsigned band) {
+        // claimed tiles are buffered, so the shared count is touched rarely
+        std::uint32_t claimed[256];
+        std::size_t count = 0;
+        auto const flush = [&] {
+            std::size_t const at = upcoming_size.fetch_add(count);
+            std::copy(claimed, claimed + count, upcoming + at);
+            count = 0;
+        };
+
+        while (current_size > 0) {
+            std::size_t const first = current_size * band / bands;
+            std::size_t const last = current_size * (band+1) / bands;
+            int const reach = level + 1;
+            for (std::size_t k = first; k < last; ++k) {
+                std::size_t const i = current[k];
+                std::uint32_t const owner = owners[i];
+                detail::for_each_neighbor(i, width, height,
+                                          [&](std::size_t j) {
+                    std::atomic_ref<int> distance{distances[j]};
+                    int seen = distance.load(std::memory_order_relaxed);
+                    if (seen == unreached and distance.compare_exchange_strong(
+                            seen, reach, std::memory_order_relaxed)) {
+                        seen = reach;
+                        claimed[count++] = static_cast<std::uint32_t>(j);
+                        if (count == std::size(claimed)) {
+                            flush();
+                        }
+                    }
+                    // only tiles of the next ring take a seed from this one
+                    if (seen != reach) {
+                        return;
+                    }
+                    std::atomic_ref<std::uint32_t> seed{owners[j]};
+                    std::uint32_t lowest = seed.load(std::memory_order_relaxed);
+                    while (owner < lowest and not seed.compare_exchange_weak(
+                               lowest, owner, std::memory_order_relaxed)) {}
+                });
+            }
+            flush();
+            sync.arrive_and_wait();
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(bands - 1);
+        for (unsigned band = 1; band < bands; ++band) {
+            workers.emplace_back(grow, band);
+        }
+        grow(0);
+    }
+    return cells;
+}
+
+/**
+ * Assign every tile of `costs` to its nearest seed, where moving onto a tile
+ * costs that tile's value.
+ *
+ * The distance of a tile is the least total cost of the tiles entered on the
+ * way there from its seed, not counting the seed's own tile. Tiles with a
+ * negative cost can't be entered, and tiles walled off from every seed are
+ * left with `no_seed`. A tile the same distance from several seeds goes to
+ * the seed with the lowest index. Costs vary from tile to tile, so the
+ * partition is grown in order of distance on one thread.
+ *
+ * \code{.cpp}
+ * hex_grid<float> travel = ...;  // negative for water
+ * auto const markets = voronoi(travel, towns);
+ * \endcode
+ *
+ * \throws std::out_of_range if a seed lies outside of the grid.
+ */
+template<typename Cost, std::ranges::input_range Seeds>
+requires std::convertible_to<std::ranges::range_reference_t<Seeds>, hex<int>>
+     and (std::integral<Cost> or std::floating_point<Cost>)
+voronoi_partition<Cost>
+voronoi(hex_grid<Cost> const & costs, Seeds const & seeds)
+{
+    std::vector<std::uint32_t> frontier;
+    auto cells = detail::place_seeds<Cost>(costs.origin(), costs.width(),
+                                           costs.height(), seeds, frontier);
+    std::uint32_t * const owners = cells.seed.data();
+    Cost * const distances = cells.distance.data();
+    Cost const * const entry = costs.data();
+
+    using entry_t = std::tuple<Cost, std::uint32_t, std::uint32_t>;
+    std::priority_queue<entry_t, std::vector<entry_t>, std::greater<>> open;
+    for (auto const i : frontier) {
+        open.emplace(Cost{0}, owners[i], i);
+    }
+    while (not open.empty()) {
+        auto const [distance, owner, i] = open.top();
+        open.pop();
+        if (distance != distances[i] or owner != owners[i]) {
+            continue;
+        }
+        detail::for_each_neighbor(i, costs.width(), costs.height(),
+                                  [&](std::size_t j) {
+            if (entry[j] < 0) {
+                return;
+            }
+            Cost const reach = distance + entry[j];
+            if (reach < distances[j]
+                or (reach == distances[j] and owner < owners[j])) {
+                distances[j] = reach;
+                owners[j] = owner;
+                open.emplace(reach, owner, static_cast<std::uint32_t>(j));
+            }
+        });
+    }
+    return cells;
+}
+}
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <array>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+using namespace tess;
+
+TEST(AutomatonTest, NeighborsFollowDirections) {
+    hex<int> const origin{-3, 2};
+    hex_grid<int> before{origin, 5, 5};
+    for (std::size_t i = 0; i < before.size(); ++i) {
+        before.data()[i] = static_cast<int>(i) + 1;
+    }
+
+    for (std::size_t d = 0; d < 6; ++d) {
+        hex_automaton<int> one{origin, 5, 5, 0, -1};
+        one.cells() = before;
+        one.step([d](int, std::array<int, 6> const & around) {
+            return around[d];
+        }, 2);
+        for (std::size_t i = 0; i < before.size(); ++i) {
+            auto const h = before.hex_at(i);
+            auto const n = h + hex_directions<int>[d];
+            EXPECT_EQ(one.cells()[h], before.contains(n)? before[n] : -1);
+        }
+    }
+}
+
+TEST(AutomatonTest, BinaryMatchesGeneric) {
+    count_rule const rule{{0, 0, 1, 0, 0, 0, 0}, {0, 0, 1, 1, 0, 0, 0}};
+    hex<int> const origin{4, -7};
+    int const width = 150;
+    int const height = 23;
+
+    binary_automaton packed{origin, width, height};
+    hex_automaton<std::uint8_t> plain{origin, width, height};
+    std::mt19937 random{7};
+    for (std::size_t i = 0; i < plain.cells().size(); ++i) {
+        bool const alive = random() % 3 == 0;
+        plain.cells().data()[i] = alive;
+        packed.set(plain.cells().hex_at(i), alive);
+    }
+
+    auto const generic = [&rule](std::uint8_t alive,
+                                 std::array<std::uint8_t, 6> const & around) {
+        int const n = std::count(around.begin(), around.end(), 1);
+        return static_cast<std::uint8_t>(alive? rule.survive[n]
+                                              : rule.birth[n]);
+    };
+    for (int generation = 0; generation < 12; ++generation) {
+        packed.step(rule, 1 + generation % 4);
+        plain.step(generic, 1 + generation % 3);
+
+        std::size_t live = 0;
+        for (std::size_t i = 0; i < plain.cells().size(); ++i) {
+            auto const h = plain.cells().hex_at(i);
+            ASSERT_EQ(packed.alive(h), plain.cells()[h] == 1);
+            live += plain.cells()[h];
+        }
+        EXPECT_EQ(packed.count(), live);
+    }
+}
+
+TEST(AutomatonTest, BinaryBounds) {
+    binary_automaton ca{hex<int>::zero, 64, 2};
+    EXPECT_EQ(ca.row_words(), 1);
+    EXPECT_FALSE(ca.alive(hex<int>{64, 0}));
+    EXPECT_THROW(ca.set(hex<int>{-1, 0}, true), std::out_of_range);
+    EXPECT_THROW((binary_automaton{hex<int>::zero, -1, 2}),
+                 std::invalid_argument);
+
+    // everything is born, but only within the bounds
+    ca.step(count_rule{{1, 1, 1, 1, 1, 1, 1}, {}});
+    EXPECT_EQ(ca.count(), 128);
+}
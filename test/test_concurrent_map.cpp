@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <functional>
+
+using namespace tess;
+
+TEST(ConcurrentMapTest, SingleThreadedOperations) {
+    concurrent_hex_map<int> map{8};
+    EXPECT_EQ(map.shard_count(), 8);
+    EXPECT_TRUE(map.insert(hex<int>{1, 2}, 5));
+    EXPECT_FALSE(map.insert(hex<int>{1, 2}, 6));
+    EXPECT_EQ(map.find(hex<int>{1, 2}), 5);
+    EXPECT_FALSE(map.insert_or_assign(hex<int>{1, 2}, 7));
+    EXPECT_EQ(map.find(hex<int>{1, 2}), 7);
+    EXPECT_EQ(map.find(hex<int>{2, 1}), std::nullopt);
+
+    map.update(hex<int>{-3, 0}, [](int & value) { value += 4; });
+    EXPECT_EQ(map.find(hex<int>{-3, 0}), 4);
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_TRUE(map.erase(hex<int>{1, 2}));
+    EXPECT_FALSE(map.contains(hex<int>{1, 2}));
+    map.clear();
+    EXPECT_EQ(map.size(), 0);
+
+    EXPECT_THROW(concurrent_hex_map<int>{6}, std::invalid_argument);
+    EXPECT_NO_THROW(concurrent_hex_map<int>{1});
+}
+
+TEST(ConcurrentMapTest, ConcurrentUpdatesAreNotLost) {
+    std::vector<hex<int>> tiles;
+    hex_range(hex<int>::zero, 10, std::back_inserter(tiles));
+
+    concurrent_hex_map<int> counts{16};
+    unsigned const threads = 8;
+    parallel_for(threads * 1000, threads,
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            for (auto i = first; i < last; ++i) {
+                counts.update(tiles[i % tiles.size()],
+                              [](int & n) { ++n; });
+            }
+        });
+
+    std::size_t total = 0;
+    counts.for_each([&](hex<int> const &, int n) { total += n; });
+    EXPECT_EQ(total, threads * 1000);
+    EXPECT_EQ(counts.size(), tiles.size());
+}
+
+TEST(ConcurrentMapTest, BatchedMergeCombines) {
+    std::vector<hex<int>> tiles;
+    hex_range(hex<int>{4, -4}, 6, std::back_inserter(tiles));
+
+    concurrent_hex_map<long> population;
+    unsigned const threads = 4;
+    parallel_for(threads, threads,
+        [&](std::size_t band, std::size_t, std::size_t) {
+            std::vector<std::pair<hex<int>, long>> local;
+            for (auto const & h : tiles) {
+                local.emplace_back(h, static_cast<long>(band) + 1);
+            }
+            population.merge(local, std::plus<>{});
+        });
+
+    auto const result = population.snapshot();
+    ASSERT_EQ(result.size(), tiles.size());
+    for (auto const & h : tiles) {
+        EXPECT_EQ(result.at(h), 1 + 2 + 3 + 4);
+    }
+}
@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <array>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+
+using namespace tess;
+
+namespace {
+constexpr std::size_t count_line(hex<int> a, hex<int> b)
+{
+    std::array<hex<int>, 64> hexes{};
+    auto const last = line(a, b, hexes.begin());
+    return static_cast<std::size_t>(last - hexes.begin());
+}
+
+constexpr bool ring_is_adjacent(int r)
+{
+    std::array<hex<int>, 60> ring{};
+    auto const last = hex_ring(hex<int>{3, -1}, r, ring.begin());
+    auto const n = last - ring.begin();
+    for (std::ptrdiff_t i = 0; i < n; ++i) {
+        if (hex_norm(ring[i] - hex<int>{3, -1}) != r) {
+            return false;
+        }
+        if (hex_norm(ring[(i+1) % n] - ring[i]) != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+// evaluated entirely at compile time
+static_assert(hex<int>{1, 2} + hex<int>{3, -4} == hex<int>{4, -2});
+static_assert(-hex<int>{1, -2} == hex<int>{-1, 2});
+static_assert(hex<int>{1, 2}.s() == -3);
+static_assert(hex_norm(hex<int>{3, -7}) == 7);
+static_assert(hex_norm(hex<double>{0.5, 0.5}) == 1.0);
+static_assert(hex_round<int>(hex<double>{0.4, 0.4}) == hex<int>{1, 0});
+static_assert(hex_round<int>(hex<double>{1.6, -0.9}) == hex<int>{2, -1});
+static_assert(hex_round<int>(hex<float>{-2.5f, 1.2f}) == hex<int>{-2, 1});
+static_assert(count_line(hex<int>{0, 0}, hex<int>{5, -2}) == 6);
+static_assert(ring_is_adjacent(1) and ring_is_adjacent(4));
+static_assert(point<int>{1, 2} + point<int>{2, 3} == point<int>{3, 5});
+static_assert(sqnorm(point<int>{3, 4}) == 25);
+
+static_assert(hex_range_offsets<int, 2>.size() == 19);
+static_assert(hex_range_offsets<int, 0>[0] == hex<int>::zero);
+static_assert(hex_ring_offsets<int, 3>.size() == 18);
+static_assert(hex_ring_offsets<int, 1>[0] == hex<int>::back_right);
+
+TEST(ConstexprTest, RoundingMatchesAtRuntime) {
+    std::mt19937 random{5};
+    std::uniform_real_distribution<double> coord{-1000, 1000};
+    for (int i = 0; i < 100000; ++i) {
+        hex<double> const h{coord(random), coord(random)};
+        auto const q = detail::round(h.q);
+        EXPECT_EQ(q, std::round(h.q));
+    }
+}
+
+TEST(ConstexprTest, TablesMatchRuntimeRanges) {
+    std::vector<hex<int>> range;
+    hex_range(hex<int>::zero, 3, std::back_inserter(range));
+    EXPECT_TRUE(std::ranges::equal(range, hex_range_offsets<int, 3>));
+
+    std::vector<hex<int>> ring;
+    hex_ring(hex<int>::zero, 3, std::back_inserter(ring));
+    EXPECT_TRUE(std::ranges::equal(ring, hex_ring_offsets<int, 3>));
+
+    // every hex of a range is on exactly one of its rings
+    std::vector<hex<int>> rings;
+    for (int r = 0; r <= 3; ++r) {
+        hex_ring(hex<int>::zero, r, std::back_inserter(rings));
+    }
+    auto const row_major = [](hex<int> const & a, hex<int> const & b) {
+        return a.r < b.r or (a.r == b.r and a.q < b.q);
+    };
+    std::ranges::sort(range, row_major);
+    std::ranges::sort(rings, row_major);
+    EXPECT_EQ(range, rings);
+}
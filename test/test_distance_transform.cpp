@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <random>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+using namespace tess;
+
+TEST(DistanceTransformTest, SingleSeedMatchesHexNorm) {
+    hex<int> const origin{-7, -4};
+    hex_grid<int> distances{origin, 15, 9, 1};
+    hex<int> const seed{2, 1};
+    distances[seed] = 0;
+
+    distance_transform(distances);
+    for (std::size_t i = 0; i < distances.size(); ++i) {
+        auto const h = distances.hex_at(i);
+        EXPECT_EQ(distances[h], hex_norm(h - seed));
+    }
+}
+
+TEST(DistanceTransformTest, SeedInCornerReachesOppositeCorner) {
+    hex_grid<int> distances{hex<int>::zero, 6, 4, 1};
+    distances[hex<int>{5, 0}] = 0;
+
+    distance_transform(distances);
+    EXPECT_EQ(distances[hex<int>(0, 3)], hex_norm(hex<int>(-5, 3)));
+    EXPECT_EQ(distances[hex<int>(5, 3)], 3);
+}
+
+TEST(DistanceTransformTest, NoSeedsIsFar) {
+    hex_grid<short> distances{hex<int>::zero, 3, 5, 7};
+    distance_transform(distances);
+    for (auto d : distances) {
+        EXPECT_EQ(d, 8);
+    }
+}
+
+TEST(DistanceTransformTest, RandomSeedsMatchBruteForce) {
+    std::mt19937 rng{12};
+    std::uniform_int_distribution<int> coin{0, 40};
+
+    hex_grid<char> terrain{hex<int>{3, -20}, 37, 23};
+    std::vector<hex<int>> seeds;
+    for (std::size_t i = 0; i < terrain.size(); ++i) {
+        terrain.data()[i] = coin(rng) == 0? 'c' : '.';
+        if (terrain.data()[i] == 'c') {
+            seeds.push_back(terrain.hex_at(i));
+        }
+    }
+    ASSERT_FALSE(seeds.empty());
+
+    auto const distances = distance_transform<int>(terrain, [](char t) {
+        return t == 'c';
+    });
+    for (std::size_t i = 0; i < distances.size(); ++i) {
+        auto const h = distances.hex_at(i);
+        int nearest = std::numeric_limits<int>::max();
+        for (auto const & seed : seeds) {
+            nearest = std::min(nearest, hex_norm(h - seed));
+        }
+        EXPECT_EQ(distances.data()[i], nearest);
+    }
+}
@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <stdexcept>
+
+using namespace tess;
+
+TEST(HexGridTest, EmptyGrid) {
+    hex_grid<int> const grid;
+    EXPECT_EQ(grid.size(), 0);
+    EXPECT_FALSE(grid.contains(hex<int>::zero));
+}
+
+TEST(HexGridTest, NegativeDimensionsThrow) {
+    EXPECT_THROW(hex_grid<int>(hex<int>::zero, -1, 3), std::invalid_argument);
+    EXPECT_THROW(hex_grid<int>(hex<int>::zero, 3, -1), std::invalid_argument);
+}
+
+TEST(HexGridTest, IndexRoundTrips) {
+    hex_grid<int> const grid{hex<int>{-3, 5}, 7, 4};
+    EXPECT_EQ(grid.size(), 28);
+    for (std::size_t i = 0; i < grid.size(); ++i) {
+        auto const h = grid.hex_at(i);
+        EXPECT_TRUE(grid.contains(h));
+        EXPECT_EQ(grid.index(h), i);
+    }
+    EXPECT_FALSE(grid.contains(hex<int>(4, 5)));
+    EXPECT_FALSE(grid.contains(hex<int>(-3, 9)));
+    EXPECT_FALSE(grid.contains(hex<int>(-4, 6)));
+}
+
+TEST(HexGridTest, NeighborsHaveFixedOffsets) {
+    hex_grid<int> const grid{hex<int>::zero, 10, 10};
+    hex<int> const h{4, 6};
+    long const i = static_cast<long>(grid.index(h));
+    long const w = grid.width();
+    EXPECT_EQ(grid.index(h + hex<int>::forward_down), i + 1);
+    EXPECT_EQ(grid.index(h + hex<int>::back_up), i - 1);
+    EXPECT_EQ(grid.index(h + hex<int>::right_down), i + w);
+    EXPECT_EQ(grid.index(h + hex<int>::left_up), i - w);
+    EXPECT_EQ(grid.index(h + hex<int>::forward_left), i - w + 1);
+    EXPECT_EQ(grid.index(h + hex<int>::back_right), i + w - 1);
+}
+
+TEST(HexGridTest, AccessTiles) {
+    hex_grid<int> grid{hex<int>{1, 1}, 3, 2, 9};
+    grid[hex<int>(2, 2)] = 4;
+    EXPECT_EQ(grid.at(hex<int>(2, 2)), 4);
+    EXPECT_EQ(grid.row(1)[1], 4);
+    EXPECT_EQ(grid.row(0)[1], 9);
+    EXPECT_THROW(grid.at(hex<int>::zero), std::out_of_range);
+
+    grid.fill(2);
+    for (auto tile : grid) {
+        EXPECT_EQ(tile, 2);
+    }
+}
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <random>
+#include <vector>
+#include <set>
+#include <tuple>
+#include <algorithm>
+#include <iterator>
+
+using namespace tess;
+
+namespace {
+struct row_major {
+    bool operator()(hex<int> const & a, hex<int> const & b) const
+    {
+        return std::tie(a.r, a.q) < std::tie(b.r, b.q);
+    }
+};
+using ordered_set = std::set<hex<int>, row_major>;
+
+ordered_set random_hexes(hex_set & into, unsigned seed)
+{
+    std::mt19937 random{seed};
+    std::uniform_int_distribution<int> q{0, into.width() - 1};
+    std::uniform_int_distribution<int> r{0, into.height() - 1};
+    ordered_set hexes;
+    for (int i = 0; i < 400; ++i) {
+        auto const h = into.origin() + hex<int>{q(random), r(random)};
+        into.insert(h);
+        hexes.insert(h);
+    }
+    return hexes;
+}
+
+ordered_set members(hex_set const & set)
+{
+    return ordered_set(set.begin(), set.end());
+}
+}
+
+TEST(HexSetTest, InsertEraseContains) {
+    hex_set set{hex<int>{-10, 5}, 70, 3};
+    EXPECT_TRUE(set.empty());
+    set.insert(hex<int>{-10, 5});
+    set.insert(hex<int>{59, 7});
+    set.insert(hex<int>{59, 7});
+    EXPECT_EQ(set.size(), 2);
+    EXPECT_TRUE(set.contains(hex<int>{59, 7}));
+    EXPECT_FALSE(set.contains(hex<int>{58, 7}));
+    EXPECT_FALSE(set.contains(hex<int>{60, 7}));
+    EXPECT_THROW(set.insert(hex<int>{60, 7}), std::out_of_range);
+
+    set.erase(hex<int>{-10, 5});
+    set.erase(hex<int>{100, 100});
+    EXPECT_EQ(set.size(), 1);
+    set.clear();
+    EXPECT_TRUE(set.empty());
+    EXPECT_THROW((hex_set{hex<int>::zero, -1, 1}), std::invalid_argument);
+}
+
+TEST(HexSetTest, IteratesInRowMajorOrder) {
+    hex_set set{hex<int>{3, -4}, 130, 9};
+    auto const expected = random_hexes(set, 1);
+    std::vector<hex<int>> visited(set.begin(), set.end());
+    EXPECT_TRUE(std::ranges::equal(visited, expected));
+    EXPECT_EQ(set.size(), expected.size());
+    EXPECT_EQ(hex_set{}.begin(), hex_set{}.end());
+}
+
+TEST(HexSetTest, SetAlgebraMatchesStdSet) {
+    hex<int> const origin{-50, 20};
+    hex_set a{origin, 100, 10};
+    hex_set b{origin, 100, 10};
+    auto const sa = random_hexes(a, 2);
+    auto const sb = random_hexes(b, 3);
+
+    auto const expect = [&](hex_set const & actual, auto algorithm) {
+        ordered_set expected;
+        algorithm(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                  std::inserter(expected, expected.end()), row_major{});
+        EXPECT_EQ(members(actual), expected);
+        EXPECT_EQ(actual.size(), expected.size());
+    };
+    expect(a | b, [](auto... args) { return std::set_union(args...); });
+    expect(a & b, [](auto... args) { return std::set_intersection(args...); });
+    expect(a - b, [](auto... args) { return std::set_difference(args...); });
+    expect(a ^ b, [](auto... args) {
+        return std::set_symmetric_difference(args...);
+    });
+
+    EXPECT_EQ((a | b) - (a ^ b), a & b);
+    EXPECT_THROW(a |= hex_set(origin, 101, 10), std::invalid_argument);
+}
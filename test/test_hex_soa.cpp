@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <random>
+#include <vector>
+#include <iterator>
+#include <stdexcept>
+#include <cstdint>
+
+using namespace tess;
+
+namespace {
+template<typename Field>
+std::vector<hex<Field>> random_hexes(std::size_t count, unsigned seed)
+{
+    std::mt19937 random{seed};
+    std::uniform_int_distribution<int> coord{-1000, 1000};
+    std::vector<hex<Field>> hexes;
+    for (std::size_t i = 0; i < count; ++i) {
+        hexes.push_back(hex<Field>{static_cast<Field>(coord(random)),
+                                   static_cast<Field>(coord(random))});
+    }
+    return hexes;
+}
+}
+
+TEST(HexSoaTest, HoldsTheSameHexesAsAnArray) {
+    auto const hexes = random_hexes<int>(1001, 1);
+    hex_soa<int> const soa{hexes};
+    ASSERT_EQ(soa.size(), hexes.size());
+    for (std::size_t i = 0; i < hexes.size(); ++i) {
+        EXPECT_EQ(soa[i], hexes[i]);
+        EXPECT_EQ(soa.q()[i], hexes[i].q);
+        EXPECT_EQ(soa.r()[i], hexes[i].r);
+    }
+    std::vector<hex<int>> copied;
+    soa.hexes(std::back_inserter(copied));
+    EXPECT_EQ(copied, hexes);
+
+    auto const address = [](auto const * p) {
+        return reinterpret_cast<std::uintptr_t>(p);
+    };
+    EXPECT_EQ(address(soa.q().data()) % hex_soa<int>::alignment, 0u);
+    EXPECT_EQ(address(soa.r().data()) % hex_soa<int>::alignment, 0u);
+}
+
+TEST(HexSoaTest, BulkArithmeticMatchesEachHex) {
+    auto const as = random_hexes<int>(777, 2);
+    auto const bs = random_hexes<int>(777, 3);
+    hex_soa<int> const a{as};
+    hex_soa<int> const b{bs};
+    hex<int> const offset{12, -40};
+
+    auto const sum = a + b;
+    auto const difference = a - b;
+    auto const shifted = a + offset;
+    auto const unshifted = shifted - offset;
+    for (std::size_t i = 0; i < as.size(); ++i) {
+        EXPECT_EQ(sum[i], as[i] + bs[i]);
+        EXPECT_EQ(difference[i], as[i] - bs[i]);
+        EXPECT_EQ(shifted[i], as[i] + offset);
+    }
+    EXPECT_EQ(unshifted, a);
+    EXPECT_FALSE(shifted == a);
+}
+
+TEST(HexSoaTest, NormsMatchEachHex) {
+    auto const ints = random_hexes<int>(513, 4);
+    auto const norms = hex_norm(hex_soa<int>{ints});
+    for (std::size_t i = 0; i < ints.size(); ++i) {
+        EXPECT_EQ(norms[i], hex_norm(ints[i]));
+    }
+
+    auto const doubles = random_hexes<double>(513, 5);
+    hex_soa<double> soa{doubles};
+    soa += hex<double>{0.25, -0.5};
+    auto const real_norms = hex_norm(soa);
+    for (std::size_t i = 0; i < doubles.size(); ++i) {
+        EXPECT_DOUBLE_EQ(real_norms[i],
+                         hex_norm(doubles[i] + hex<double>{0.25, -0.5}));
+    }
+}
+
+TEST(HexSoaTest, DistancesMatchEachHex) {
+    auto const hexes = random_hexes<int>(300, 6);
+    hex<int> const to{-17, 250};
+    auto const distances = hex_distance(hex_soa<int>{hexes}, to);
+    for (std::size_t i = 0; i < hexes.size(); ++i) {
+        EXPECT_EQ(distances[i], hex_norm(hexes[i] - to));
+    }
+}
+
+TEST(HexSoaTest, GrowsAndShrinks) {
+    hex_soa<int> soa;
+    EXPECT_TRUE(soa.empty());
+    soa.push_back(hex<int>{1, 2});
+    soa.resize(3, hex<int>{-1, 4});
+    soa.set(1, hex<int>{7, 7});
+    EXPECT_EQ(soa.size(), 3u);
+    EXPECT_EQ(soa[0], (hex<int>{1, 2}));
+    EXPECT_EQ(soa[1], (hex<int>{7, 7}));
+    EXPECT_EQ(soa[2], (hex<int>{-1, 4}));
+    soa.clear();
+    EXPECT_TRUE(soa.empty());
+}
+
+TEST(HexSoaTest, MismatchedSizesThrow) {
+    hex_soa<int> a{4};
+    hex_soa<int> const b{5};
+    EXPECT_THROW(a += b, std::invalid_argument);
+    EXPECT_THROW(a - b, std::invalid_argument);
+
+    std::vector<int> norms(3);
+    EXPECT_THROW(hex_norm(a, std::span<int>{norms}), std::invalid_argument);
+    EXPECT_THROW(hex_distance(a, hex<int>::zero, std::span<int>{norms}),
+                 std::invalid_argument);
+}
@@ -0,0 +1,176 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <random>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+using namespace tess;
+
+std::vector<point<float>> random_points(std::size_t n, unsigned seed)
+{
+    std::mt19937 rng{seed};
+    std::normal_distribution<float> coord{0.f, 120.f};
+    std::vector<point<float>> points;
+    for (std::size_t i = 0; i < n; ++i) {
+        points.push_back(point<float>{coord(rng), coord(rng)});
+    }
+    return points;
+}
+
+TEST(HexbinTest, SinglePoints) {
+    pointed_fbasis const basis{0.f, 0.f, 10.f};
+    hexbin<float, HexTop::Pointed> bins{basis, hex<int>{-2, -2}, 5, 5};
+    bins.add(point<float>{0.f, 0.f}, 3.f);
+    bins.add(point<float>{1.f, -2.f}, -1.f);
+    bins.add(basis.pixel<point<float>>(hex<int>{1, 1}));
+    bins.add(point<float>{1000.f, 0.f});
+
+    auto const & zero = bins.cells()[hex<int>::zero];
+    EXPECT_EQ(zero.count, 2);
+    EXPECT_FLOAT_EQ(zero.sum, 2.f);
+    EXPECT_FLOAT_EQ(zero.min, -1.f);
+    EXPECT_FLOAT_EQ(zero.max, 3.f);
+    EXPECT_EQ(bins.cells()[hex<int>(1, 1)].count, 1);
+    EXPECT_EQ(bins.cells()[hex<int>(1, 0)].count, 0);
+    EXPECT_EQ(bins.outside(), 1);
+}
+
+TEST(HexbinTest, ThreadedMatchesSequential) {
+    flat_fbasis const basis{3.f, -4.f, 15.f};
+    auto const points = random_points(20000, 32);
+    std::vector<float> weights;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        weights.push_back(static_cast<float>(i % 17) - 5.f);
+    }
+
+    hexbin<float, HexTop::Flat> bins{basis, hex<int>{-20, -20}, 40, 40};
+    bins.add(points, weights, 4);
+
+    std::unordered_map<hex<int>, hexbin_cell<float>> expected;
+    std::size_t outside = 0;
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        auto const h = hex_round<int>(basis.hex(points[i]));
+        if (bins.cells().contains(h)) {
+            expected[h].add(weights[i]);
+        }
+        else {
+            ++outside;
+        }
+    }
+    EXPECT_EQ(bins.outside(), outside);
+    for (std::size_t i = 0; i < bins.cells().size(); ++i) {
+        auto const & cell = bins.cells().data()[i];
+        auto const found = expected.find(bins.cells().hex_at(i));
+        if (found == expected.end()) {
+            EXPECT_EQ(cell.count, 0);
+            continue;
+        }
+        EXPECT_EQ(cell.count, found->second.count);
+        EXPECT_FLOAT_EQ(cell.sum, found->second.sum);
+        EXPECT_FLOAT_EQ(cell.min, found->second.min);
+        EXPECT_FLOAT_EQ(cell.max, found->second.max);
+    }
+}
+
+TEST(HexbinTest, SmallBatchesOnLargeRegions) {
+    pointed_fbasis const basis{0.f, 0.f, 1.f};
+    hexbin<float, HexTop::Pointed> bins{basis, hex<int>{-500, -500},
+                                        1000, 1000};
+    auto const points = random_points(300, 4);
+    bins.add(points, 8);
+
+    std::size_t total = bins.outside();
+    for (auto const & p : points) {
+        auto const h = hex_round<int>(basis.hex(p));
+        if (bins.cells().contains(h)) {
+            EXPECT_GE(bins.cells()[h].count, 1);
+        }
+    }
+    for (auto const & cell : bins.cells()) {
+        total += cell.count;
+    }
+    EXPECT_EQ(total, points.size());
+}
+
+TEST(HexbinTest, BinPointsFitsEveryPoint) {
+    pointed_fbasis const basis{0.f, 0.f, 8.f};
+    auto const points = random_points(5000, 9);
+    auto const bins = bin_points(basis, points, 3);
+    EXPECT_EQ(bins.outside(), 0);
+
+    std::size_t total = 0;
+    for (auto const & cell : bins.cells()) {
+        total += cell.count;
+    }
+    EXPECT_EQ(total, points.size());
+
+    auto const empty = bin_points(basis, std::vector<point<float>>{});
+    EXPECT_EQ(empty.cells().size(), 0);
+}
+
+TEST(HexbinTest, MergeRequiresSameRegion) {
+    pointed_fbasis const basis{0.f, 0.f, 8.f};
+    hexbin<float, HexTop::Pointed> a{basis, hex<int>::zero, 4, 4};
+    hexbin<float, HexTop::Pointed> b{basis, hex<int>::zero, 4, 4};
+    hexbin<float, HexTop::Pointed> c{basis, hex<int>::zero, 4, 5};
+    a.add(point<float>{0.f, 0.f});
+    b.add(point<float>{0.f, 0.f}, 5.f);
+    b.add(point<float>{-100.f, 0.f});
+    a.merge(b);
+    EXPECT_EQ(a.cells()[hex<int>::zero].count, 2);
+    EXPECT_FLOAT_EQ(a.cells()[hex<int>::zero].max, 5.f);
+    EXPECT_EQ(a.outside(), 1);
+    EXPECT_THROW(a.merge(c), std::invalid_argument);
+}
+
+template<typename Scalar>
+std::filesystem::path write_records(std::vector<point<float>> const & points,
+                                    char const * name, std::size_t trailing)
+{
+    auto const path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out{path, std::ios::binary};
+    for (auto const & p : points) {
+        Scalar const record[2] = {static_cast<Scalar>(p.x),
+                                  static_cast<Scalar>(p.y)};
+        out.write(reinterpret_cast<char const *>(record), sizeof(record));
+    }
+    out.write("garbage", static_cast<std::streamsize>(trailing));
+    return path;
+}
+
+TEST(HexbinTest, BinFileMatchesInMemory) {
+    pointed_fbasis const basis{0.f, 0.f, 12.f};
+    auto const points = random_points(30000, 33);
+
+    hexbin<float, HexTop::Pointed> expected{basis, hex<int>{-30, -30}, 60, 60};
+    expected.add(points, 1);
+
+    auto const doubles = write_records<double>(points, "tess_bin_d.bin", 5);
+    hexbin<float, HexTop::Pointed> bins{basis, hex<int>{-30, -30}, 60, 60};
+    bin_file<double>(bins, doubles, 10000, 3);
+    std::filesystem::remove(doubles);
+
+    auto const floats = write_records<float>(points, "tess_bin_f.bin", 0);
+    hexbin<float, HexTop::Pointed> fbins{basis, hex<int>{-30, -30}, 60, 60};
+    bin_file<float>(fbins, floats, 1);
+    std::filesystem::remove(floats);
+
+    EXPECT_EQ(bins.outside(), expected.outside());
+    EXPECT_EQ(fbins.outside(), expected.outside());
+    for (std::size_t i = 0; i < expected.cells().size(); ++i) {
+        EXPECT_EQ(bins.cells().data()[i].count,
+                  expected.cells().data()[i].count);
+        EXPECT_EQ(fbins.cells().data()[i].count,
+                  expected.cells().data()[i].count);
+    }
+}
+
+TEST(HexbinTest, BinFileThrowsIfMissing) {
+    pointed_fbasis const basis{0.f, 0.f, 12.f};
+    hexbin<float, HexTop::Pointed> bins{basis, hex<int>::zero, 1, 1};
+    EXPECT_THROW(bin_file<float>(bins, "/nonexistent/tess.bin"),
+                 std::system_error);
+}
@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace tess;
+
+TEST(HierarchyTest, ChildrenShareTheirParent) {
+    for (int q = -12; q <= 12; ++q) {
+        for (int r = -12; r <= 12; ++r) {
+            hex<int> const p{q, r};
+            std::vector<hex<int>> children;
+            hex_children(p, std::back_inserter(children));
+            ASSERT_EQ(children.size(), 7);
+            EXPECT_EQ(children[0], hex_center_child(p));
+            for (auto const & child : children) {
+                EXPECT_EQ(hex_parent(child), p);
+            }
+        }
+    }
+}
+
+TEST(HierarchyTest, ParentsTileThePlane) {
+    std::unordered_map<hex<int>, int> counts;
+    std::vector<hex<int>> fine;
+    hex_range(hex<int>::zero, 20, std::back_inserter(fine));
+    for (auto const & h : fine) {
+        auto const p = hex_parent(h);
+        EXPECT_LE(hex_norm(h - hex_center_child(p)), 1);
+        ++counts[p];
+    }
+    // coarse hexes well inside the range have all seven children
+    EXPECT_EQ(counts[hex<int>::zero], 7);
+    EXPECT_EQ(counts[hex<int>(1, 1)], 7);
+}
+
+TEST(HierarchyTest, AncestorsAndDescendants) {
+    hex<long> const h{-123, 456};
+    auto const grandparent = hex_ancestor(h, 2);
+    EXPECT_EQ(grandparent, hex_parent(hex_parent(h)));
+    EXPECT_EQ(hex_ancestor(h, 0), h);
+
+    hex<long> const coarse{3, -2};
+    EXPECT_EQ(hex_ancestor(hex_descendant(coarse, 4), 4), coarse);
+}
+
+TEST(HierarchyTest, AggregateSumsChildren) {
+    std::unordered_map<hex<int>, int> population;
+    std::vector<hex<int>> children;
+    hex_children(hex<int>(2, -1), std::back_inserter(children));
+    for (auto const & child : children) {
+        population[child] = 3;
+    }
+    population[hex<int>::zero] = 5;
+
+    auto const regions = aggregate_parents(population);
+    ASSERT_EQ(regions.size(), 2);
+    EXPECT_EQ(regions.at(hex<int>(2, -1)), 21);
+    EXPECT_EQ(regions.at(hex<int>::zero), 5);
+
+    auto const largest = aggregate_parents(population, [](int a, int b) {
+        return std::max(a, b);
+    });
+    EXPECT_EQ(largest.at(hex<int>(2, -1)), 3);
+}
+
+TEST(HierarchyTest, AggregateGrid) {
+    hex_grid<long> grid{hex<int>{-10, -10}, 21, 21, 1};
+    auto const regions = aggregate_parents(grid);
+    long total = 0;
+    for (auto const & [p, count] : regions) {
+        EXPECT_LE(count, 7);
+        total += count;
+    }
+    EXPECT_EQ(total, 21*21);
+    EXPECT_EQ(regions.at(hex<int>::zero), 7);
+}
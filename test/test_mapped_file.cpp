@@ -0,0 +1,40 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace tess;
+
+TEST(MappedFileTest, MapsWindows) {
+    auto const path = std::filesystem::temp_directory_path() / "tess_map.bin";
+    std::size_t const page = mapped_file::page_size();
+    {
+        std::ofstream out{path, std::ios::binary};
+        for (std::size_t i = 0; i < 2*page + 10; ++i) {
+            out.put(static_cast<char>(i % 251));
+        }
+    }
+
+    mapped_file file{path};
+    EXPECT_EQ(file.size(), 2*page + 10);
+
+    auto const all = file.map();
+    ASSERT_EQ(all.size(), 2*page + 10);
+    EXPECT_EQ(static_cast<int>(all[300]), 300 % 251);
+
+    auto const tail = file.map(2*page, page);
+    ASSERT_EQ(tail.size(), 10);
+    EXPECT_EQ(static_cast<int>(tail[0]), (2*page) % 251);
+
+    EXPECT_TRUE(file.map(4*page, page).empty());
+    EXPECT_THROW(file.map(1, 1), std::invalid_argument);
+
+    mapped_file moved{std::move(file)};
+    EXPECT_EQ(moved.size(), 2*page + 10);
+    std::filesystem::remove(path);
+}
+
+TEST(MappedFileTest, MissingFileThrows) {
+    EXPECT_THROW(mapped_file{"/nonexistent/tess.bin"}, std::system_error);
+}
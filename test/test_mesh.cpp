@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <array>
+#include <vector>
+
+using namespace tess;
+
+using color = unsigned;
+using mesh = pointed_fmesh<point<float>, color>;
+
+TEST(MeshTest, InsertWritesVerticesAndIndices) {
+    pointed_fbasis const basis{100.f, 50.f, 10.f};
+    mesh tiles{basis};
+    tiles.insert(hex<int>::zero, 1);
+    tiles.insert(hex<int>::right_down, 2);
+
+    ASSERT_EQ(tiles.size(), 2);
+    ASSERT_EQ(tiles.positions().size(), 12);
+    ASSERT_EQ(tiles.indices().size(), 24);
+
+    std::array<point<float>, 6> verts;
+    basis.vertices<point<float>>(hex<int>::right_down, verts.begin());
+    auto const first = tiles.first_vertex(hex<int>::right_down);
+    EXPECT_EQ(first, 6);
+    for (std::size_t i = 0; i < 6; ++i) {
+        EXPECT_EQ(tiles.positions()[first + i], verts[i]);
+        EXPECT_EQ(tiles.colors()[first + i], 2);
+    }
+    for (auto i : tiles.indices()) {
+        EXPECT_LT(i, 12);
+    }
+}
+
+TEST(MeshTest, RecolorReportsOnlyChangedTiles) {
+    pointed_fbasis const basis{0.f, 0.f, 10.f};
+    mesh tiles{basis};
+    std::vector<hex<int>> hexes;
+    hex_range(hex<int>::zero, 3, std::back_inserter(hexes));
+    for (auto const & h : hexes) {
+        tiles.insert(h, 0);
+    }
+    EXPECT_EQ(tiles.dirty_colors().size(), 1);
+    EXPECT_EQ(tiles.dirty_positions().size(), 1);
+    EXPECT_TRUE(tiles.indices_resized());
+    tiles.clear_dirty();
+    EXPECT_TRUE(tiles.dirty_colors().empty());
+
+    tiles.set_color(hexes[4], 7);
+    tiles.set_color(hexes[5], 7);
+    tiles.set_color(hexes[20], 7);
+    tiles.set_color(hexes[4], 8);
+
+    auto const spans = tiles.dirty_colors();
+    ASSERT_EQ(spans.size(), 2);
+    std::size_t const tile_bytes = 6 * sizeof(color);
+    EXPECT_EQ(spans[0].offset, 4 * tile_bytes);
+    EXPECT_EQ(spans[0].size, 2 * tile_bytes);
+    EXPECT_EQ(spans[1].offset, 20 * tile_bytes);
+    EXPECT_EQ(spans[1].size, tile_bytes);
+    EXPECT_EQ(tiles.colors()[4*6], 8);
+    EXPECT_EQ(tiles.colors()[5*6 + 5], 7);
+
+    EXPECT_TRUE(tiles.dirty_positions().empty());
+    EXPECT_FALSE(tiles.indices_resized());
+}
+
+TEST(MeshTest, EraseMovesLastTile) {
+    flat_fbasis const basis{0.f, 0.f, 4.f};
+    flat_fmesh<point<float>, color> tiles{basis};
+    tiles.insert(hex<int>{0, 0}, 1);
+    tiles.insert(hex<int>{1, 0}, 2);
+    tiles.insert(hex<int>{2, 0}, 3);
+    tiles.clear_dirty();
+
+    EXPECT_TRUE(tiles.erase(hex<int>{0, 0}));
+    EXPECT_FALSE(tiles.erase(hex<int>{0, 0}));
+    EXPECT_FALSE(tiles.contains(hex<int>{0, 0}));
+    ASSERT_EQ(tiles.size(), 2);
+    EXPECT_EQ(tiles.positions().size(), 12);
+    EXPECT_EQ(tiles.indices().size(), 24);
+    EXPECT_EQ(tiles.first_vertex(hex<int>{2, 0}), 0);
+    EXPECT_EQ(tiles.colors()[0], 3);
+
+    auto const spans = tiles.dirty_colors();
+    ASSERT_EQ(spans.size(), 1);
+    EXPECT_EQ(spans[0].offset, 0);
+    ASSERT_EQ(tiles.dirty_positions().size(), 1);
+    EXPECT_EQ(tiles.dirty_positions()[0].offset, 0);
+    EXPECT_TRUE(tiles.indices_resized());
+    tiles.clear_dirty();
+    EXPECT_FALSE(tiles.indices_resized());
+
+    EXPECT_THROW(tiles.set_color(hex<int>{0, 0}, 1), std::out_of_range);
+}
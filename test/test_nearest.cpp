@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+using namespace tess;
+
+namespace {
+std::vector<hex<int>> random_tiles(std::size_t count, int extent,
+                                   unsigned seed)
+{
+    std::mt19937 random{seed};
+    std::uniform_int_distribution<int> coord{-extent, extent};
+    std::vector<hex<int>> tiles;
+    for (std::size_t i = 0; i < count; ++i) {
+        tiles.push_back(hex<int>{coord(random), coord(random)});
+    }
+    return tiles;
+}
+
+// the distances of the k nearest targets, nearest first
+std::vector<int> nearest_distances(std::vector<hex<int>> const & targets,
+                                   hex<int> const & from, std::size_t k)
+{
+    std::vector<int> distances;
+    for (auto const & t : targets) {
+        distances.push_back(hex_norm(t - from));
+    }
+    std::ranges::sort(distances);
+    distances.resize(std::min(k, distances.size()));
+    return distances;
+}
+}
+
+TEST(NearestTest, DistanceMatrixMatchesEachPair) {
+    auto const queries = random_tiles(37, 500, 1);
+    auto const targets = random_tiles(101, 500, 2);
+    std::vector<int> distances(queries.size() * targets.size());
+    hex_distances(hex_soa<int>{queries}, hex_soa<int>{targets},
+                  std::span<int>{distances}, 3);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        for (std::size_t j = 0; j < targets.size(); ++j) {
+            EXPECT_EQ(distances[i * targets.size() + j],
+                      hex_norm(queries[i] - targets[j]));
+        }
+    }
+
+    std::vector<int> wrong(5);
+    EXPECT_THROW(hex_distances(hex_soa<int>{queries}, hex_soa<int>{targets},
+                               std::span<int>{wrong}),
+                 std::invalid_argument);
+}
+
+TEST(NearestTest, FindsTheNearestTargets) {
+    // dense targets are found by rings, sparse ones by scanning
+    for (int extent : {10, 40, 2000}) {
+        auto const targets = random_tiles(300, extent, 3);
+        nearest_index const index{targets};
+        EXPECT_EQ(index.size(), targets.size());
+        for (auto const & from : random_tiles(50, extent + 5, 4)) {
+            for (std::size_t k : {1u, 4u, 17u}) {
+                std::vector<std::size_t> found;
+                index.nearest(from, k, std::back_inserter(found));
+                ASSERT_EQ(found.size(), k);
+                std::vector<int> distances;
+                for (auto const i : found) {
+                    distances.push_back(hex_norm(targets[i] - from));
+                }
+                EXPECT_EQ(distances, nearest_distances(targets, from, k));
+                std::ranges::sort(found);
+                EXPECT_EQ(std::ranges::adjacent_find(found), found.end());
+            }
+        }
+    }
+}
+
+TEST(NearestTest, SharedTilesAndShortfalls) {
+    std::vector<hex<int>> const targets{{0, 0}, {3, -1}, {0, 0}, {-2, 2}};
+    nearest_index const index{targets};
+    auto const here = index.at(hex<int>::zero);
+    EXPECT_EQ(std::vector<std::size_t>(here.begin(), here.end()),
+              (std::vector<std::size_t>{0, 2}));
+    EXPECT_TRUE(index.at(hex<int>{9, 9}).empty());
+
+    std::vector<std::size_t> found;
+    index.nearest(hex<int>{1, 0}, 10, std::back_inserter(found));
+    EXPECT_EQ(found.size(), targets.size());
+    EXPECT_EQ(found.back(), 3u);
+
+    found.clear();
+    nearest_index const empty{std::vector<hex<int>>{}};
+    empty.nearest(hex<int>::zero, 3, std::back_inserter(found));
+    EXPECT_TRUE(found.empty());
+}
+
+TEST(NearestTest, BatchMatchesSingleQueries) {
+    auto const targets = random_tiles(1000, 60, 5);
+    auto const queries = random_tiles(200, 60, 6);
+    nearest_index const index{targets};
+    std::size_t const k = 5;
+    std::vector<std::size_t> batch(queries.size() * k);
+    index.nearest(queries, k, batch, 4);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        std::vector<int> distances;
+        for (std::size_t j = 0; j < k; ++j) {
+            distances.push_back(hex_norm(targets[batch[i*k + j]] - queries[i]));
+        }
+        EXPECT_EQ(distances, nearest_distances(targets, queries[i], k));
+    }
+
+    // missing targets are filled in with npos
+    nearest_index const few{std::vector<hex<int>>{{1, 1}}};
+    std::vector<std::size_t> padded(2 * 3);
+    few.nearest(std::vector<hex<int>>{{0, 0}, {5, 5}}, 3, padded);
+    EXPECT_EQ(padded, (std::vector<std::size_t>{0, nearest_index::npos,
+                                                nearest_index::npos, 0,
+                                                nearest_index::npos,
+                                                nearest_index::npos}));
+    EXPECT_THROW(few.nearest(queries, 3, padded), std::invalid_argument);
+}
@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+#include <span>
+#include <stdexcept>
+
+using namespace tess;
+
+TEST(NoiseTest, PositionIsPixelWithoutRounding) {
+    flat_fbasis const flat{3.f, -7.f, 9.f};
+    pointed_fbasis const pointed{-5.f, 1.f, 7.f};
+    for (int q = -5; q <= 5; ++q) {
+        for (int r = -5; r <= 5; ++r) {
+            hex<int> const h{q, r};
+            auto const p = flat.position(h);
+            auto const pixel = flat.pixel<point<int>>(h);
+            EXPECT_EQ(static_cast<int>(std::round(p.x)), pixel.x);
+            EXPECT_EQ(static_cast<int>(std::round(p.y)), pixel.y);
+            EXPECT_EQ(hex_round<int>(pointed.hex(pointed.position(h))), h);
+        }
+    }
+}
+
+TEST(NoiseTest, SamplesAreSeededSmoothAndBounded) {
+    simplex_noise const noise{7};
+    simplex_noise const other{8};
+    std::mt19937 random{50};
+    std::uniform_real_distribution<double> coord{-1000.0, 1000.0};
+    double sum = 0;
+    double squares = 0;
+    int differ = 0;
+    int const count = 20000;
+    for (int i = 0; i < count; ++i) {
+        double const x = coord(random);
+        double const y = coord(random);
+        double const value = noise(x, y);
+        EXPECT_LE(std::abs(value), 1.0);
+        EXPECT_EQ(value, noise(x, y));
+        EXPECT_NEAR(value, noise(x + 1e-4, y - 1e-4), 1e-2);
+        EXPECT_NEAR(noise(static_cast<float>(x), static_cast<float>(y)),
+                    value, 1e-2);
+        differ += value != other(x, y);
+        sum += value;
+        squares += value * value;
+    }
+    EXPECT_GT(differ, count * 9/10);
+    EXPECT_NEAR(sum / count, 0.0, 0.05);
+    EXPECT_GT(squares / count, 0.05);
+}
+
+TEST(NoiseTest, BulkSamplesMatchSingleSamples) {
+    simplex_noise const noise{3};
+    std::vector<float> xs, ys;
+    for (int i = 0; i < 1000; ++i) {
+        xs.push_back(i * 0.173f - 80.f);
+        ys.push_back(i * -0.091f + 12.f);
+    }
+    std::vector<float> values(xs.size());
+    noise(std::span<float const>{xs}, std::span<float const>{ys},
+          std::span<float>{values});
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        EXPECT_EQ(values[i], noise(xs[i], ys[i]));
+    }
+    values.pop_back();
+    EXPECT_THROW(noise(std::span<float const>{xs}, std::span<float const>{ys},
+                       std::span<float>{values}),
+                 std::invalid_argument);
+}
+
+TEST(NoiseTest, RowSamplesMatchSingleSamples) {
+    simplex_noise const noise{5};
+    point<double> const start{-31.5, 7.25};
+    point<double> const step{0.37, -0.11};
+    std::vector<double> values(500);
+    noise(start, step, std::span<double>{values});
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        double const x = start.x + static_cast<double>(i) * step.x;
+        double const y = start.y + static_cast<double>(i) * step.y;
+        EXPECT_DOUBLE_EQ(values[i], noise(x, y));
+    }
+}
+
+TEST(NoiseTest, FilledGridsSampleTileCenters) {
+    pointed_fbasis const basis{10.f, -4.f, 6.f};
+    simplex_noise const noise{11};
+    float const frequency = 1/40.f;
+
+    hex_grid<float> tiles{hex<int>{-20, 5}, 50, 30};
+    fill_noise(tiles, basis, noise, frequency, 1, 3);
+    for (int r = 0; r < tiles.height(); ++r) {
+        for (int q = 0; q < tiles.width(); ++q) {
+            auto const h = tiles.origin() + hex<int>{q, r};
+            auto const p = basis.position(h);
+            EXPECT_NEAR(tiles[h], noise(p.x * frequency, p.y * frequency),
+                        1e-4f);
+        }
+    }
+
+    // chunks filled separately join up with a grid filled all at once
+    hex_grid<float> whole{hex<int>::zero, 64, 32};
+    hex_grid<float> left{hex<int>::zero, 32, 32};
+    hex_grid<float> right{hex<int>{32, 0}, 32, 32};
+    for (auto * grid : {&whole, &left, &right}) {
+        fill_noise(*grid, basis, noise, frequency, 4, 2);
+    }
+    for (auto const * chunk : {&left, &right}) {
+        for (int r = 0; r < chunk->height(); ++r) {
+            for (int q = 0; q < chunk->width(); ++q) {
+                auto const h = chunk->origin() + hex<int>{q, r};
+                EXPECT_NEAR((*chunk)[h], whole[h], 1e-4f);
+                EXPECT_LE(std::abs(whole[h]), 1.f);
+            }
+        }
+    }
+    EXPECT_THROW(fill_noise(whole, basis, noise, frequency, 0),
+                 std::invalid_argument);
+}
@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <vector>
+
+using namespace tess;
+
+TEST(OffsetTest, OddRMatchesKnownValues) {
+    EXPECT_EQ(to_axial(odd_r<int>{0, 0}), hex<int>(0, 0));
+    EXPECT_EQ(to_axial(odd_r<int>{2, 1}), hex<int>(2, 1));
+    EXPECT_EQ(to_axial(odd_r<int>{2, 2}), hex<int>(1, 2));
+    EXPECT_EQ(to_axial(odd_r<int>{0, 3}), hex<int>(-1, 3));
+    EXPECT_EQ(to_axial(odd_r<int>{0, -1}), hex<int>(1, -1));
+}
+
+TEST(OffsetTest, EvenQMatchesKnownValues) {
+    EXPECT_EQ(to_axial(even_q<int>{1, 0}), hex<int>(1, -1));
+    EXPECT_EQ(to_axial(even_q<int>{2, 2}), hex<int>(2, 1));
+    EXPECT_EQ(to_axial(even_q<int>{-1, 0}), hex<int>(-1, 0));
+}
+
+template<OffsetStyle Style>
+void expect_round_trip()
+{
+    for (int q = -9; q <= 9; ++q) {
+        for (int r = -9; r <= 9; ++r) {
+            hex<int> const h{q, r};
+            EXPECT_EQ(to_axial(to_offset<Style>(h)), h);
+        }
+    }
+}
+
+TEST(OffsetTest, RoundTripsEveryStyle) {
+    expect_round_trip<OffsetStyle::OddR>();
+    expect_round_trip<OffsetStyle::EvenR>();
+    expect_round_trip<OffsetStyle::OddQ>();
+    expect_round_trip<OffsetStyle::EvenQ>();
+}
+
+template<OffsetStyle Style>
+void expect_map_matches_tiles()
+{
+    int const width = 7;
+    int const height = 5;
+    std::vector<hex<int>> hexes;
+    offset_map_to_axial<Style>(width, height, std::back_inserter(hexes));
+    ASSERT_EQ(hexes.size(), width * height);
+    for (int row = 0; row < height; ++row) {
+        for (int col = 0; col < width; ++col) {
+            offset<int, Style> const o{col, row};
+            EXPECT_EQ(hexes[row*width + col], to_axial(o));
+        }
+    }
+
+    std::vector<offset<int, Style>> offsets;
+    to_offset<Style>(hexes.begin(), hexes.end(), std::back_inserter(offsets));
+    for (std::size_t i = 0; i < offsets.size(); ++i) {
+        EXPECT_EQ(offsets[i].col, static_cast<int>(i) % width);
+        EXPECT_EQ(offsets[i].row, static_cast<int>(i) / width);
+    }
+}
+
+TEST(OffsetTest, MapMatchesTiles) {
+    expect_map_matches_tiles<OffsetStyle::OddR>();
+    expect_map_matches_tiles<OffsetStyle::EvenR>();
+    expect_map_matches_tiles<OffsetStyle::OddQ>();
+    expect_map_matches_tiles<OffsetStyle::EvenQ>();
+}
+
+TEST(OffsetTest, RowMatchesTiles) {
+    std::vector<hex<long>> hexes;
+    offset_row_to_axial<OffsetStyle::OddQ>(-3l, -4l, 9l,
+                                           std::back_inserter(hexes));
+    ASSERT_EQ(hexes.size(), 9);
+    for (long i = 0; i < 9; ++i) {
+        EXPECT_EQ(hexes[i], to_axial(odd_q<long>{-4 + i, -3}));
+    }
+
+    hexes.clear();
+    offset_row_to_axial<OffsetStyle::EvenR>(5l, 2l, 3l,
+                                            std::back_inserter(hexes));
+    ASSERT_EQ(hexes.size(), 3);
+    EXPECT_EQ(hexes[0], to_axial(even_r<long>{2, 5}));
+    EXPECT_EQ(hexes[2], to_axial(even_r<long>{4, 5}));
+}
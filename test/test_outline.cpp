@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace tess;
+
+using polygons = std::vector<outline<point<int>>>;
+
+TEST(OutlineTest, EmptySetHasNoOutlines) {
+    pointed_fbasis const basis{0.f, 0.f, 10.f};
+    polygons borders;
+    outlines<point<int>>(basis, std::vector<hex<int>>{},
+                         std::back_inserter(borders));
+    EXPECT_TRUE(borders.empty());
+}
+
+template<typename Basis>
+void expect_single_hex_matches_vertices(Basis const & basis)
+{
+    hex<int> const h{3, -2};
+    polygons borders;
+    outlines<point<int>>(basis, std::vector{h}, std::back_inserter(borders));
+    ASSERT_EQ(borders.size(), 1);
+    EXPECT_FALSE(borders[0].is_hole);
+
+    std::array<point<int>, 6> verts;
+    basis.template vertices<point<int>>(h, verts.begin());
+    auto const & actual = borders[0].vertices;
+    ASSERT_EQ(actual.size(), 6);
+    for (auto const & v : verts) {
+        EXPECT_NE(std::find(actual.begin(), actual.end(), v), actual.end());
+    }
+}
+
+TEST(OutlineTest, SingleHexMatchesVertices) {
+    expect_single_hex_matches_vertices(pointed_fbasis{5.f, 7.f, 20.f});
+    expect_single_hex_matches_vertices(flat_fbasis{-3.f, 2.f, 11.f});
+}
+
+TEST(OutlineTest, RangeHasOneOuterOutline) {
+    flat_fbasis const basis{0.f, 0.f, 30.f};
+    std::vector<hex<int>> tiles;
+    hex_range(hex<int>{1, 1}, 2, std::back_inserter(tiles));
+
+    polygons borders;
+    outlines<point<int>>(basis, tiles, std::back_inserter(borders));
+    ASSERT_EQ(borders.size(), 1);
+    EXPECT_FALSE(borders[0].is_hole);
+    EXPECT_EQ(borders[0].vertices.size(), 30);
+}
+
+TEST(OutlineTest, RingHasOuterAndHole) {
+    pointed_fbasis const basis{0.f, 0.f, 30.f};
+    std::vector<hex<int>> tiles;
+    for (auto const & d : hex_directions<int>) {
+        tiles.push_back(d);
+    }
+
+    polygons borders;
+    outlines<point<int>>(basis, tiles, std::back_inserter(borders));
+    ASSERT_EQ(borders.size(), 2);
+    auto const hole = std::find_if(borders.begin(), borders.end(),
+                                   [](auto const & b) { return b.is_hole; });
+    ASSERT_NE(hole, borders.end());
+    EXPECT_EQ(hole->vertices.size(), 6);
+    auto const outer = hole == borders.begin()? borders.end()-1
+                                               : borders.begin();
+    EXPECT_FALSE(outer->is_hole);
+    EXPECT_EQ(outer->vertices.size(), 18);
+
+    std::array<point<int>, 6> verts;
+    basis.vertices<point<int>>(hex<int>::zero, verts.begin());
+    for (auto const & v : hole->vertices) {
+        EXPECT_NE(std::find(verts.begin(), verts.end(), v), verts.end());
+    }
+}
+
+TEST(OutlineTest, DisjointRegionsAreSeparate) {
+    flat_fbasis const basis{0.f, 0.f, 10.f};
+    std::vector<hex<int>> const tiles{
+        hex<int>{0, 0}, hex<int>{1, 0}, hex<int>{5, 5}
+    };
+    polygons borders;
+    outlines<point<int>>(basis, tiles, std::back_inserter(borders));
+    ASSERT_EQ(borders.size(), 2);
+    EXPECT_EQ(borders[0].vertices.size(), 10);
+    EXPECT_EQ(borders[1].vertices.size(), 6);
+}
@@ -0,0 +1,184 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <random>
+#include <vector>
+#include <set>
+#include <tuple>
+#include <iterator>
+#include <stdexcept>
+
+using namespace tess;
+
+namespace {
+using match_key = std::tuple<int, int, int>;
+
+std::set<match_key> keys(std::vector<pattern_match> const & matches)
+{
+    std::set<match_key> found;
+    for (auto const & m : matches) {
+        found.emplace(m.origin.q, m.origin.r, m.symmetry);
+    }
+    return found;
+}
+
+// try every origin and symmetry one tile at a time
+std::set<match_key> brute_force(hex_set const & tiles,
+                                hex_pattern const & pattern)
+{
+    std::set<match_key> found;
+    for (int s = 0; s < hex_symmetry_count; ++s) {
+        auto const variant = pattern.transformed(s);
+        for (int r = -20; r < tiles.height() + 20; ++r) {
+            for (int q = -20; q < tiles.width() + 20; ++q) {
+                auto const origin = tiles.origin() + hex<int>{q, r};
+                bool fits = true;
+                for (auto const & p : variant.present()) {
+                    fits = fits and tiles.contains(origin + p);
+                }
+                for (auto const & p : variant.absent()) {
+                    fits = fits and tiles.in_bounds(origin + p)
+                                and not tiles.contains(origin + p);
+                }
+                if (fits) {
+                    found.emplace(origin.q, origin.r, s);
+                }
+            }
+        }
+    }
+    return found;
+}
+}
+
+TEST(PatternTest, SymmetriesFormTheDihedralGroup) {
+    hex<int> const h{3, -1};
+    EXPECT_EQ(hex_symmetry(h, 0), h);
+    EXPECT_EQ(hex_symmetry(hex<int>{1, 0}, 1), (hex<int>{0, 1}));
+    for (int s = 0; s < hex_symmetry_count; ++s) {
+        EXPECT_EQ(hex_norm(hex_symmetry(h, s)), hex_norm(h));
+    }
+
+    // six rotations come back around, and every reflection undoes itself
+    auto turned = h;
+    for (int i = 0; i < 6; ++i) {
+        turned = hex_symmetry(turned, 1);
+    }
+    EXPECT_EQ(turned, h);
+    for (int s = 6; s < hex_symmetry_count; ++s) {
+        EXPECT_EQ(hex_symmetry(hex_symmetry(h, s), s), h);
+    }
+
+    // all twelve images of an asymmetric hex are different
+    std::set<std::pair<int, int>> images;
+    for (int s = 0; s < hex_symmetry_count; ++s) {
+        auto const image = hex_symmetry(h, s);
+        images.emplace(image.q, image.r);
+    }
+    EXPECT_EQ(images.size(), 12u);
+}
+
+TEST(PatternTest, FindsEveryOrientationOfAnAsymmetricShape) {
+    hex_set tiles{hex<int>{-5, 4}, 20, 10};
+    hex_pattern const hook{{{0, 0}, {1, 0}, {2, 0}, {2, 1}}};
+    auto const placed = hook.transformed(7);
+    hex<int> const origin{4, 8};
+    for (auto const & p : placed.present()) {
+        tiles.insert(origin + p);
+    }
+
+    std::vector<pattern_match> matches;
+    match_pattern(tiles, hook, std::back_inserter(matches));
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0], (pattern_match{origin, 7}));
+
+    matches.clear();
+    match_pattern(tiles, hook, std::back_inserter(matches), false);
+    EXPECT_TRUE(matches.empty());
+}
+
+TEST(PatternTest, SymmetricShapesMatchOncePerPlace) {
+    hex_set tiles{hex<int>::zero, 12, 12};
+    hex_pattern const flower{{{0, 0}, {1, 0}, {1, -1}, {0, -1},
+                              {-1, 0}, {-1, 1}, {0, 1}}};
+    for (auto const & p : flower.present()) {
+        tiles.insert(hex<int>{5, 5} + p);
+    }
+    std::vector<pattern_match> matches;
+    match_pattern(tiles, flower, std::back_inserter(matches));
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].origin, (hex<int>{5, 5}));
+    EXPECT_EQ(matches[0].symmetry, 0);
+}
+
+TEST(PatternTest, MatchesBruteForceOnRandomTiles) {
+    std::mt19937 random{44};
+    hex_pattern const patterns[] = {
+        hex_pattern{{{0, 0}, {1, 0}}},
+        hex_pattern{{{0, 0}, {1, -1}, {1, 0}}, {{2, -1}}},
+        hex_pattern{{{0, 0}, {2, 0}}, {{1, 0}, {0, 1}}},
+        hex_pattern{{}, {{0, 0}, {1, 0}, {0, 1}}},
+    };
+    // widths either side of a word boundary
+    for (int width : {7, 63, 64, 65, 130}) {
+        hex_set tiles{hex<int>{-3, 2}, width, 9};
+        std::bernoulli_distribution set{0.6};
+        for (int r = 0; r < tiles.height(); ++r) {
+            for (int q = 0; q < tiles.width(); ++q) {
+                if (set(random)) {
+                    tiles.insert(tiles.origin() + hex<int>{q, r});
+                }
+            }
+        }
+        for (auto const & pattern : patterns) {
+            std::vector<pattern_match> matches;
+            match_pattern(tiles, pattern, std::back_inserter(matches));
+            auto const found = keys(matches);
+            EXPECT_EQ(found.size(), matches.size());
+
+            // every symmetry's placements are reported, under the first
+            // symmetry that gives the same shape
+            auto const expected = brute_force(tiles, pattern);
+            for (auto const & [q, r, s] : found) {
+                EXPECT_TRUE(expected.contains({q, r, s}));
+            }
+            for (auto const & [q, r, s] : expected) {
+                auto const variant = pattern.transformed(s);
+                bool reported = false;
+                for (auto const & [fq, fr, fs] : found) {
+                    if (reported) break;
+                    auto const other = pattern.transformed(fs);
+                    // the same tiles, placed from another origin
+                    std::set<std::pair<int, int>> a, b;
+                    for (auto const & p : variant.present()) {
+                        a.emplace(q + p.q, r + p.r);
+                    }
+                    for (auto const & p : variant.absent()) {
+                        a.emplace(q + p.q + 100000, r + p.r);
+                    }
+                    for (auto const & p : other.present()) {
+                        b.emplace(fq + p.q, fr + p.r);
+                    }
+                    for (auto const & p : other.absent()) {
+                        b.emplace(fq + p.q + 100000, fr + p.r);
+                    }
+                    reported = a == b;
+                }
+                EXPECT_TRUE(reported);
+            }
+        }
+    }
+}
+
+TEST(PatternTest, RejectsEmptyAndContradictoryPatterns) {
+    EXPECT_THROW((hex_pattern{{}}), std::invalid_argument);
+    EXPECT_THROW((hex_pattern{{{0, 0}}, {{0, 0}}}), std::invalid_argument);
+}
+
+TEST(PatternTest, PatternsLargerThanTheRegionDontMatch) {
+    hex_set tiles{hex<int>::zero, 2, 2};
+    tiles.insert(hex<int>{0, 0});
+    tiles.insert(hex<int>{1, 0});
+    std::vector<pattern_match> matches;
+    match_pattern(tiles, hex_pattern{{{0, 0}, {1, 0}, {2, 0}}},
+                  std::back_inserter(matches));
+    EXPECT_TRUE(matches.empty());
+}
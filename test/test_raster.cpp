@@ -0,0 +1,380 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <numbers>
+#include <unordered_set>
+
+using namespace tess;
+
+std::unordered_set<hex<int>> unique(std::vector<hex<int>> const & hexes)
+{
+    std::unordered_set<hex<int>> const set(hexes.begin(), hexes.end());
+    EXPECT_EQ(set.size(), hexes.size());
+    return set;
+}
+
+// every sampled point strictly inside the shape must lie in a returned hex
+template<typename Basis, typename Inside>
+void expect_covers(Basis const & basis, std::vector<hex<int>> const & hexes,
+                   point<float> low, point<float> high, Inside && inside)
+{
+    auto const set = unique(hexes);
+    for (float x = low.x; x <= high.x; x += 0.37f) {
+        for (float y = low.y; y <= high.y; y += 0.37f) {
+            point<float> const p{x, y};
+            if (inside(p)) {
+                auto const h = hex_round<int>(basis.hex(p));
+                EXPECT_TRUE(set.contains(h)) << x << ", " << y;
+            }
+        }
+    }
+}
+
+using dpoint = point<double>;
+
+// the exact corners of `h`, which `Basis::vertices` rounds to whole pixels
+template<std::floating_point R, HexTop TopStyle>
+std::array<dpoint, 6> hexagon(Basis<R, TopStyle> const & basis,
+                              hex<int> const & h)
+{
+    auto const c = basis.position(h);
+    double const offset = TopStyle == HexTop::Pointed? std::numbers::pi/6 : 0;
+    std::array<dpoint, 6> hexagon;
+    for (int i = 0; i < 6; ++i) {
+        double const theta = offset + i * std::numbers::pi/3;
+        hexagon[i] = dpoint{c.x + basis.unit_size() * std::cos(theta),
+                            c.y + basis.unit_size() * std::sin(theta)};
+    }
+    return hexagon;
+}
+
+// how far the circle reaches into the hexagon; positive when they overlap
+double circle_overlap(std::array<dpoint, 6> const & hexagon, dpoint c,
+                      double radius)
+{
+    bool inside = true;
+    double nearest = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < 6; ++i) {
+        auto const a = hexagon[i];
+        auto const b = hexagon[(i+1) % 6];
+        dpoint const ab{b.x - a.x, b.y - a.y};
+        dpoint const ac{c.x - a.x, c.y - a.y};
+        double const t = std::clamp((ac.x*ab.x + ac.y*ab.y)
+                                    / (ab.x*ab.x + ab.y*ab.y), 0.0, 1.0);
+        nearest = std::min(nearest, std::hypot(ac.x - t*ab.x,
+                                               ac.y - t*ab.y));
+        // the hexagon's winding is fixed, so the sign of every side agrees
+        inside = inside and (ab.x*ac.y - ab.y*ac.x)
+                            * (ab.x*(hexagon[(i+2) % 6].y - a.y)
+                             - ab.y*(hexagon[(i+2) % 6].x - a.x)) > 0;
+    }
+    return inside? radius + nearest : radius - nearest;
+}
+
+// the smallest overlap of the shapes' projections onto any edge normal;
+// convex shapes share area exactly when this is positive
+template<typename Polygon>
+double polygon_overlap(std::array<dpoint, 6> const & hexagon,
+                       Polygon const & polygon)
+{
+    double overlap = std::numeric_limits<double>::infinity();
+    auto const project = [&](auto const & edges) {
+        for (std::size_t i = 0; i < edges.size(); ++i) {
+            auto const a = edges[i];
+            auto const b = edges[(i+1) % edges.size()];
+            double const length = std::hypot(b.x - a.x, b.y - a.y);
+            dpoint const n{(a.y - b.y) / length, (b.x - a.x) / length};
+            double lo0 = std::numeric_limits<double>::infinity();
+            double hi0 = -lo0, lo1 = lo0, hi1 = -lo0;
+            for (auto const & v : hexagon) {
+                lo0 = std::min(lo0, v.x*n.x + v.y*n.y);
+                hi0 = std::max(hi0, v.x*n.x + v.y*n.y);
+            }
+            for (auto const & v : polygon) {
+                lo1 = std::min(lo1, v.x*n.x + v.y*n.y);
+                hi1 = std::max(hi1, v.x*n.x + v.y*n.y);
+            }
+            overlap = std::min(overlap, std::min(hi0, hi1)
+                                      - std::max(lo0, lo1));
+        }
+    };
+    project(hexagon);
+    project(polygon);
+    return overlap;
+}
+
+// every hex within `reach` hexes of `center` is in `hexes` exactly when its
+// overlap is positive; hexes the shape barely grazes are skipped, since the
+// rasterizer works in single precision
+template<typename Basis, typename Overlap>
+void expect_exact(Basis const & basis, std::vector<hex<int>> const & hexes,
+                  point<float> center, int reach, Overlap && overlap)
+{
+    auto const set = unique(hexes);
+    auto const middle = hex_round<int>(basis.hex(center));
+    std::vector<hex<int>> candidates;
+    hex_range(middle, reach, std::back_inserter(candidates));
+    for (auto const & h : hexes) {
+        EXPECT_LE(hex_norm(h - middle), reach);
+    }
+    double const tolerance = 1e-3 * basis.unit_size();
+    for (auto const & h : candidates) {
+        double const margin = overlap(hexagon(basis, h));
+        if (std::abs(margin) > tolerance) {
+            EXPECT_EQ(set.contains(h), margin > 0)
+                << h.q << ", " << h.r << " overlaps by " << margin;
+        }
+    }
+}
+
+TEST(RasterTest, SmallCircleIsOneHex) {
+    pointed_fbasis const basis{10.f, 20.f, 10.f};
+    hex<int> const h{2, -1};
+    auto const c = basis.pixel<point<float>>(h);
+    float const apothem = std::sqrt(3.f)/2 * 10.f;
+
+    std::vector<hex<int>> inner;
+    rasterize_circle(basis, c, apothem - 0.5f, std::back_inserter(inner));
+    ASSERT_EQ(inner.size(), 1);
+    EXPECT_EQ(inner[0], h);
+
+    std::vector<hex<int>> outer;
+    rasterize_circle(basis, c, apothem + 0.5f, std::back_inserter(outer));
+    EXPECT_EQ(outer.size(), 7);
+    for (auto const & tile : outer) {
+        EXPECT_LE(hex_norm(tile - h), 1);
+    }
+}
+
+TEST(RasterTest, CircleCoversSamples) {
+    std::mt19937 rng{30};
+    std::uniform_real_distribution<float> coord{-100.f, 100.f};
+    std::uniform_real_distribution<float> size{1.f, 60.f};
+
+    flat_fbasis const flat{3.f, -7.f, 9.f};
+    pointed_fbasis const pointed{-5.f, 1.f, 7.f};
+    for (int i = 0; i < 10; ++i) {
+        point<float> const c{coord(rng), coord(rng)};
+        float const radius = size(rng);
+        auto const inside = [&](point<float> const & p) {
+            return norm(p - c) < radius;
+        };
+        point<float> const low{c.x - radius, c.y - radius};
+        point<float> const high{c.x + radius, c.y + radius};
+
+        std::vector<hex<int>> hexes;
+        rasterize_circle(flat, c, radius, std::back_inserter(hexes));
+        expect_covers(flat, hexes, low, high, inside);
+
+        hexes.clear();
+        rasterize_circle(pointed, c, radius, std::back_inserter(hexes));
+        expect_covers(pointed, hexes, low, high, inside);
+
+        // no hex can be further than a hex's circumradius from the circle
+        for (auto const & h : hexes) {
+            auto const center = pointed.pixel<point<float>>(h);
+            EXPECT_LT(norm(center - c), radius + 7.f + 1.f);
+        }
+    }
+}
+
+TEST(RasterTest, CapsuleCoversSamples) {
+    pointed_fbasis const basis{0.f, 0.f, 5.f};
+    point<float> const a{-30.f, 12.f};
+    point<float> const b{41.f, -20.f};
+    float const radius = 6.f;
+
+    std::vector<hex<int>> hexes;
+    rasterize_capsule(basis, a, b, radius, std::back_inserter(hexes));
+    expect_covers(basis, hexes, point<float>{-40.f, -30.f},
+                  point<float>{50.f, 20.f}, [&](point<float> const & p) {
+        auto const ab = b - a;
+        auto const ap = p - a;
+        float t = (ap.x*ab.x + ap.y*ab.y) / sqnorm(ab);
+        t = std::clamp(t, 0.f, 1.f);
+        return norm(point<float>{ap.x - t*ab.x, ap.y - t*ab.y}) < radius;
+    });
+}
+
+TEST(RasterTest, SweptCircleIncludesGrazedHexes) {
+    pointed_fbasis const basis{0.f, 0.f, 10.f};
+    hex<int> const start{0, 0};
+    hex<int> const end{4, 0};
+    auto const a = basis.pixel<point<float>>(start);
+    auto const b = basis.pixel<point<float>>(end);
+
+    // a body wider than the gap between rows reaches the neighboring rows
+    std::vector<hex<int>> swept;
+    rasterize_capsule(basis, a, b, 9.f, std::back_inserter(swept));
+    auto const set = unique(swept);
+    std::vector<hex<int>> centers;
+    line(start, end, std::back_inserter(centers));
+    for (auto const & h : centers) {
+        EXPECT_TRUE(set.contains(h));
+    }
+    EXPECT_GT(set.size(), centers.size());
+    EXPECT_TRUE(set.contains(hex<int>{2, 1}));
+    EXPECT_TRUE(set.contains(hex<int>{2, -1}));
+}
+
+TEST(RasterTest, ThickLineCoversSamples) {
+    flat_fbasis const basis{-2.f, 5.f, 4.f};
+    point<float> const a{-25.f, -9.f};
+    point<float> const b{30.f, 17.f};
+    float const thickness = 7.f;
+
+    std::vector<hex<int>> hexes;
+    rasterize_line(basis, a, b, thickness, std::back_inserter(hexes));
+    auto const ab = b - a;
+    float const length = norm(ab);
+    auto const inside = [&](point<float> const & p) {
+        auto const ap = p - a;
+        float const along = (ap.x*ab.x + ap.y*ab.y) / length;
+        float const across = (ap.x*ab.y - ap.y*ab.x) / length;
+        return 0.f < along and along < length
+           and std::abs(across) < thickness/2;
+    };
+    expect_covers(basis, hexes, point<float>{-35.f, -20.f},
+                  point<float>{40.f, 28.f}, inside);
+
+    // square ends don't reach as far past the ends as round ones
+    std::vector<hex<int>> capsule;
+    rasterize_capsule(basis, a, b, thickness/2, std::back_inserter(capsule));
+    auto const round = unique(capsule);
+    for (auto const & h : hexes) {
+        EXPECT_TRUE(round.contains(h));
+    }
+
+    hexes.clear();
+    rasterize_line(basis, a, a, thickness, std::back_inserter(hexes));
+    rasterize_line(basis, a, b, 0.f, std::back_inserter(hexes));
+    EXPECT_TRUE(hexes.empty());
+}
+
+TEST(RasterTest, BoxCoversSamples) {
+    flat_fbasis const basis{4.f, 4.f, 6.f};
+    std::vector<point<float>> const box{{-20.f, -13.f}, {35.f, -13.f},
+                                        {35.f, 22.f}, {-20.f, 22.f}};
+    std::vector<hex<int>> hexes;
+    rasterize_polygon(basis, box, std::back_inserter(hexes));
+    expect_covers(basis, hexes, box[0], box[2], [](point<float> const &) {
+        return true;
+    });
+
+    // hexes entirely outside the box must not be included
+    for (auto const & h : hexes) {
+        auto const c = basis.pixel<point<float>>(h);
+        EXPECT_GT(c.x, -20.f - 6.f);
+        EXPECT_LT(c.x, 35.f + 6.f);
+        EXPECT_GT(c.y, -13.f - 6.f);
+        EXPECT_LT(c.y, 22.f + 6.f);
+    }
+}
+
+TEST(RasterTest, TriangleInsideHexIsOneHex) {
+    pointed_fbasis const basis{0.f, 0.f, 20.f};
+    std::vector<point<int>> const triangle{{-3, -3}, {4, -2}, {0, 5}};
+    std::vector<hex<int>> hexes;
+    rasterize_polygon(basis, triangle, std::back_inserter(hexes));
+    ASSERT_EQ(hexes.size(), 1);
+    EXPECT_EQ(hexes[0], hex<int>::zero);
+
+    hexes.clear();
+    rasterize_polygon(basis, std::vector<point<int>>{{0, 0}, {1, 1}},
+                      std::back_inserter(hexes));
+    EXPECT_TRUE(hexes.empty());
+}
+
+TEST(RasterTest, CirclesAreExact) {
+    std::mt19937 rng{46};
+    std::uniform_real_distribution<float> coord{-60.f, 60.f};
+    std::uniform_real_distribution<float> size{0.5f, 30.f};
+    flat_fbasis const flat{3.f, -7.f, 9.f};
+    pointed_fbasis const pointed{-5.f, 1.f, 7.f};
+
+    for (int i = 0; i < 40; ++i) {
+        point<float> const c{coord(rng), coord(rng)};
+        float const radius = size(rng);
+        dpoint const dc{c.x, c.y};
+        auto const overlap = [&](std::array<dpoint, 6> const & hexagon) {
+            return circle_overlap(hexagon, dc, radius);
+        };
+
+        std::vector<hex<int>> hexes;
+        rasterize_circle(flat, c, radius, std::back_inserter(hexes));
+        expect_exact(flat, hexes, c, static_cast<int>(radius / 9.f) + 3,
+                     overlap);
+
+        hexes.clear();
+        rasterize_circle(pointed, c, radius, std::back_inserter(hexes));
+        expect_exact(pointed, hexes, c, static_cast<int>(radius / 7.f) + 3,
+                     overlap);
+    }
+}
+
+TEST(RasterTest, ConvexPolygonsAreExact) {
+    std::mt19937 rng{47};
+    std::uniform_real_distribution<float> coord{-40.f, 40.f};
+    std::uniform_real_distribution<float> size{1.f, 25.f};
+    std::uniform_real_distribution<float> turn{0.f, 6.2831853f};
+    flat_fbasis const flat{1.f, 2.f, 6.f};
+    pointed_fbasis const pointed{-3.f, 4.f, 5.f};
+
+    for (int i = 0; i < 40; ++i) {
+        // random points on an ellipse, sorted by angle, are convex
+        point<float> const c{coord(rng), coord(rng)};
+        float const rx = size(rng);
+        float const ry = size(rng);
+        std::vector<float> angles(3 + i % 5);
+        for (auto & angle : angles) {
+            angle = turn(rng);
+        }
+        std::sort(angles.begin(), angles.end());
+        std::vector<point<float>> polygon;
+        std::vector<dpoint> dpolygon;
+        for (auto angle : angles) {
+            polygon.push_back(point<float>{c.x + rx*std::cos(angle),
+                                           c.y + ry*std::sin(angle)});
+            dpolygon.push_back(dpoint{polygon.back().x, polygon.back().y});
+        }
+        auto const overlap = [&](std::array<dpoint, 6> const & hexagon) {
+            return polygon_overlap(hexagon, dpolygon);
+        };
+        int const reach = static_cast<int>(std::max(rx, ry) / 5.f) + 3;
+
+        std::vector<hex<int>> hexes;
+        rasterize_polygon(flat, polygon, std::back_inserter(hexes));
+        expect_exact(flat, hexes, c, reach, overlap);
+
+        hexes.clear();
+        rasterize_polygon(pointed, polygon, std::back_inserter(hexes));
+        expect_exact(pointed, hexes, c, reach, overlap);
+    }
+}
+
+TEST(RasterTest, RepeatedVerticesAreIgnored) {
+    flat_fbasis const basis{0.f, 0.f, 5.f};
+    std::vector<point<float>> const open{{-10.f, -10.f}, {10.f, -10.f},
+                                         {10.f, 10.f}, {-10.f, 10.f}};
+    std::vector<hex<int>> expected;
+    rasterize_polygon(basis, open, std::back_inserter(expected));
+    ASSERT_FALSE(expected.empty());
+
+    auto closed = open;
+    closed.push_back(open.front());
+    std::vector<hex<int>> hexes;
+    rasterize_polygon(basis, closed, std::back_inserter(hexes));
+    EXPECT_EQ(hexes, expected);
+
+    std::vector<point<float>> const repeated{
+        open[0], open[0], open[1], open[2], open[2], open[2], open[3],
+        open[0], open[0]};
+    hexes.clear();
+    rasterize_polygon(basis, repeated, std::back_inserter(hexes));
+    EXPECT_EQ(hexes, expected);
+}
@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <cmath>
+#include <random>
+#include <vector>
+#include <unordered_set>
+#include <iterator>
+#include <stdexcept>
+
+using namespace tess;
+
+namespace {
+// every sample along the ray must lie in the crossing that spans it
+template<HexTop TopStyle>
+void expect_matches_samples(Basis<double, TopStyle> const & basis,
+                            point<double> const & origin,
+                            point<double> const & direction, double length)
+{
+    std::vector<ray_crossing<double>> crossings;
+    trace_ray(basis, origin, direction, length, std::back_inserter(crossings));
+    ASSERT_FALSE(crossings.empty());
+    EXPECT_EQ(crossings.front().enter, 0.0);
+    EXPECT_EQ(crossings.back().exit, length);
+
+    std::unordered_set<hex<int>> seen;
+    for (std::size_t i = 0; i < crossings.size(); ++i) {
+        auto const & c = crossings[i];
+        EXPECT_TRUE(seen.insert(c.tile).second);
+        EXPECT_LE(c.enter, c.exit);
+        if (i > 0) {
+            EXPECT_EQ(hex_norm(c.tile - crossings[i-1].tile), 1);
+            EXPECT_DOUBLE_EQ(c.enter, crossings[i-1].exit);
+        }
+    }
+
+    double const n = std::sqrt(sqnorm(direction));
+    point<double> const unit{direction.x / n, direction.y / n};
+    std::size_t at = 0;
+    for (double t = 0.01; t < length; t += 0.05) {
+        while (at < crossings.size() and crossings[at].exit < t) {
+            ++at;
+        }
+        ASSERT_LT(at, crossings.size());
+        // skip samples too close to an edge to tell which side they're on
+        if (t - crossings[at].enter < 1e-6 or crossings[at].exit - t < 1e-6) {
+            continue;
+        }
+        point<double> const p{origin.x + t*unit.x, origin.y + t*unit.y};
+        EXPECT_EQ(hex_round<int>(basis.hex(p)), crossings[at].tile)
+            << "at distance " << t;
+    }
+}
+}
+
+TEST(RayTest, CrossingsMatchSamplesAlongTheRay) {
+    std::mt19937 random{47};
+    std::uniform_real_distribution<double> coord{-50.0, 50.0};
+    Basis<double, HexTop::Pointed> const pointed{3.0, -2.0, 7.0};
+    Basis<double, HexTop::Flat> const flat{-10.0, 4.0, 5.0};
+    for (int i = 0; i < 20; ++i) {
+        point<double> const origin{coord(random), coord(random)};
+        point<double> const direction{coord(random), coord(random)};
+        expect_matches_samples(pointed, origin, direction, 150.0);
+        expect_matches_samples(flat, origin, direction, 150.0);
+    }
+}
+
+TEST(RayTest, AxisAlignedRaysStepOneHexAtATime) {
+    Basis<double, HexTop::Pointed> const basis{0.0, 0.0, 10.0};
+    double const width = std::sqrt(3.0) * 10.0;
+
+    // straight along a row, through the middle of each edge
+    hex_ray ray{basis, point<double>{0.0, 0.0}, point<double>{1.0, 0.0}};
+    for (int q = 0; q < 10; ++q) {
+        EXPECT_EQ(ray.tile(), (hex<int>{q, 0}));
+        EXPECT_NEAR(ray.exit(), width * (q + 0.5), 1e-9);
+        ray.advance();
+    }
+}
+
+TEST(RayTest, CastStopsAtTheFirstOpaqueHex) {
+    pointed_fbasis const basis{0.f, 0.f, 10.f};
+    point<float> const origin{0.f, 0.f};
+    point<float> const east{1.f, 0.f};
+    auto const wall = [](hex<int> const & h) { return h.q == 4; };
+
+    auto const hit = cast_ray(basis, origin, east, 1000.f, wall);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->tile, (hex<int>{4, 0}));
+    EXPECT_NEAR(hit->enter, std::sqrt(3.f) * 10.f * 3.5f, 1e-3f);
+
+    EXPECT_FALSE(cast_ray(basis, origin, east, 50.f, wall).has_value());
+    EXPECT_FALSE(cast_ray(basis, origin, point<float>{-1.f, 0.f}, 1000.f,
+                          wall).has_value());
+}
+
+TEST(RayTest, RejectsDegenerateRays) {
+    pointed_fbasis const basis{0.f, 0.f, 10.f};
+    point<float> const origin{1.f, 2.f};
+    std::vector<ray_crossing<float>> crossings;
+    EXPECT_THROW(trace_ray(basis, origin, point<float>{0.f, 0.f}, 10.f,
+                           std::back_inserter(crossings)),
+                 std::invalid_argument);
+    EXPECT_THROW(trace_ray(basis, origin, point<float>{1.f, 0.f}, -1.f,
+                           std::back_inserter(crossings)),
+                 std::invalid_argument);
+    float const nan = std::nanf("");
+    EXPECT_THROW(trace_ray(basis, origin, point<float>{1.f, 0.f}, nan,
+                           std::back_inserter(crossings)),
+                 std::invalid_argument);
+    EXPECT_THROW(cast_ray(basis, origin, point<float>{1.f, 0.f}, nan,
+                          [](hex<int> const &) { return false; }),
+                 std::invalid_argument);
+}
@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <atomic>
+#include <vector>
+#include <stdexcept>
+
+using namespace tess;
+
+namespace {
+// determine if any tile within `halo` of `chunk` lies in `other`
+bool reaches(hex_chunk const & chunk, hex_chunk const & other, int halo)
+{
+    for (int r = -halo; r < chunk.height + halo; ++r) {
+        for (int q = -halo; q < chunk.width + halo; ++q) {
+            auto const h = chunk.origin + hex<int>{q, r};
+            bool within = false;
+            for (int y = 0; y < chunk.height and not within; ++y) {
+                for (int x = 0; x < chunk.width and not within; ++x) {
+                    within = hex_norm(h - (chunk.origin + hex<int>{x, y}))
+                          <= halo;
+                }
+            }
+            if (within and other.contains(h)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+}
+
+TEST(SchedulerTest, ChunksCoverTheRegion) {
+    chunk_scheduler const scheduler{hex<int>{-7, 3}, 50, 23, 8, 5, 1, 3};
+    EXPECT_EQ(scheduler.columns(), 7);
+    EXPECT_EQ(scheduler.rows(), 5);
+    EXPECT_EQ(scheduler.colors(), 3);
+
+    hex_grid<int> owners{hex<int>{-7, 3}, 50, 23, 0};
+    for (auto const & chunk : scheduler.chunks()) {
+        for (int r = 0; r < chunk.height; ++r) {
+            for (int q = 0; q < chunk.width; ++q) {
+                ++owners.at(chunk.origin + hex<int>{q, r});
+            }
+        }
+    }
+    for (auto const n : owners) {
+        EXPECT_EQ(n, 1);
+    }
+
+    EXPECT_THROW((chunk_scheduler{hex<int>::zero, 10, 10, 0, 4}),
+                 std::invalid_argument);
+    EXPECT_THROW((chunk_scheduler{hex<int>::zero, 10, 10, 4, 4, 5}),
+                 std::invalid_argument);
+}
+
+TEST(SchedulerTest, SameColoredChunksNeverConflict) {
+    for (int halo : {0, 1, 2, 3}) {
+        chunk_scheduler const scheduler{hex<int>::zero, 30, 30, 3, 4, halo, 2};
+        auto const & chunks = scheduler.chunks();
+        for (auto const & a : chunks) {
+            for (auto const & b : chunks) {
+                if (&a != &b and a.color == b.color) {
+                    EXPECT_FALSE(reaches(a, b, halo));
+                }
+            }
+        }
+    }
+}
+
+TEST(SchedulerTest, TicksEveryChunkOncePerPhase) {
+    chunk_scheduler scheduler{hex<int>::zero, 200, 120, 16, 16, 2, 6};
+    auto const & chunks = scheduler.chunks();
+    std::vector<std::atomic<int>> visits(chunks.size());
+    std::vector<std::atomic<bool>> active(chunks.size());
+    std::atomic<bool> conflict = false;
+
+    for (int tick = 0; tick < 5; ++tick) {
+        scheduler.tick([&](hex_chunk const & chunk) {
+            std::size_t const i = chunk.row * scheduler.columns() + chunk.column;
+            active[i] = true;
+            for (std::size_t j = 0; j < chunks.size(); ++j) {
+                if (j != i and active[j] and chunks[j].color != chunk.color) {
+                    conflict = true;
+                }
+            }
+            ++visits[i];
+            active[i] = false;
+        });
+    }
+    EXPECT_FALSE(conflict);
+    for (auto const & n : visits) {
+        EXPECT_EQ(n, 5);
+    }
+}
+
+TEST(SchedulerTest, RethrowsUpdateErrors) {
+    chunk_scheduler scheduler{hex<int>::zero, 64, 64, 8, 8, 1, 4};
+    std::atomic<int> calls = 0;
+    EXPECT_THROW(scheduler.tick([&](hex_chunk const & chunk) {
+        ++calls;
+        if (chunk.column == 2 and chunk.row == 2) {
+            throw std::runtime_error{"failed"};
+        }
+    }), std::runtime_error);
+    EXPECT_LT(calls, 64);
+
+    // the scheduler is still usable afterwards
+    calls = 0;
+    scheduler.tick([&](hex_chunk const &) { ++calls; });
+    EXPECT_EQ(calls, 64);
+}
@@ -0,0 +1,188 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <random>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+
+using namespace tess;
+
+namespace {
+std::vector<std::byte> bytes_of(std::stringstream const & stream)
+{
+    auto const text = stream.str();
+    std::vector<std::byte> bytes(text.size());
+    std::memcpy(bytes.data(), text.data(), text.size());
+    return bytes;
+}
+}
+
+TEST(SerializeTest, TileSetRoundTrips) {
+    std::mt19937 random{11};
+    std::uniform_int_distribution<int> coord{-100000, 100000};
+    std::unordered_set<hex<int>> hexes;
+    for (int i = 0; i < 1000; ++i) {
+        hexes.insert(hex<int>{coord(random), coord(random)});
+    }
+    hex_range(hex<int>{-3, 4}, 20, std::inserter(hexes, hexes.end()));
+
+    std::stringstream stream;
+    std::vector<hex<int>> repeated(hexes.begin(), hexes.end());
+    repeated.push_back(hex<int>{-3, 4});
+    save_tile_set(stream, repeated);
+    auto const bytes = bytes_of(stream);
+
+    tile_set_view const set{bytes};
+    EXPECT_EQ(set.size(), hexes.size());
+    for (auto const & h : hexes) {
+        EXPECT_TRUE(set.contains(h));
+    }
+    EXPECT_FALSE(set.contains(hex<int>{-3, 25}));
+    EXPECT_FALSE(set.contains(hex<int>{200000, 0}));
+    EXPECT_FALSE(set.contains(hex<int>{-200000, -200000}));
+
+    std::size_t visited = 0;
+    hex<int> last{0, -1000000};
+    set.for_each([&](hex<int> const & h) {
+        EXPECT_TRUE(hexes.contains(h));
+        EXPECT_TRUE(last.r < h.r or (last.r == h.r and last.q < h.q));
+        last = h;
+        ++visited;
+    });
+    EXPECT_EQ(visited, hexes.size());
+}
+
+TEST(SerializeTest, DenseSetsAreCompact) {
+    std::vector<hex<int>> hexes;
+    hex_range(hex<int>::zero, 50, std::back_inserter(hexes));
+    std::stringstream stream;
+    save_tile_set(stream, hexes);
+    EXPECT_LT(stream.str().size(), hexes.size() * 3);
+}
+
+TEST(SerializeTest, TileMapMapsFromFile) {
+    std::unordered_map<hex<int>, float> fertility;
+    std::vector<hex<int>> hexes;
+    hex_range(hex<int>{7, -2}, 12, std::back_inserter(hexes));
+    for (auto const & h : hexes) {
+        fertility[h] = static_cast<float>(h.q * 100 + h.r);
+    }
+
+    auto const path = std::filesystem::temp_directory_path() / "tess_map.tiles";
+    {
+        std::ofstream out{path, std::ios::binary};
+        save_tile_map(out, fertility);
+    }
+    {
+        mapped_tiles<tile_map_view<float>> const map{path};
+        EXPECT_EQ(map->size(), fertility.size());
+        for (auto const & [h, value] : fertility) {
+            ASSERT_NE(map->find(h), nullptr);
+            EXPECT_EQ(map->at(h), value);
+        }
+        EXPECT_EQ(map->find(hex<int>{100, 100}), nullptr);
+        EXPECT_THROW(map->at(hex<int>{100, 100}), std::out_of_range);
+
+        std::size_t visited = 0;
+        map->for_each([&](hex<int> const & h, float value) {
+            EXPECT_EQ(fertility.at(h), value);
+            ++visited;
+        });
+        EXPECT_EQ(visited, fertility.size());
+
+        EXPECT_THROW(mapped_tiles<tile_map_view<double>>{path},
+                     std::invalid_argument);
+        EXPECT_THROW(mapped_tiles<tile_set_view>{path}, std::invalid_argument);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(SerializeTest, CorruptHeadersAreRejected) {
+    std::unordered_map<hex<int>, float> tiles;
+    for (int q = 0; q < 100; ++q) {
+        tiles[hex<int>{q, -q}] = static_cast<float>(q);
+    }
+    std::stringstream stream;
+    save_tile_map(stream, tiles);
+    auto const bytes = bytes_of(stream);
+    ASSERT_NO_THROW(tile_map_view<float>{bytes});
+
+    // count sits after the magic, version and value size; blocks follows it
+    auto const corrupt = [&](std::uint64_t count, std::uint64_t blocks) {
+        auto copy = bytes;
+        std::memcpy(copy.data() + 16, &count, sizeof(count));
+        std::memcpy(copy.data() + 24, &blocks, sizeof(blocks));
+        return copy;
+    };
+    std::uint64_t const huge = std::numeric_limits<std::uint64_t>::max();
+    for (auto const & copy : {corrupt(huge, 0), corrupt(huge, huge / 64 + 1),
+                              corrupt(huge / 4 + 1, 0),
+                              corrupt(huge / 4 + 1, (huge / 4 + 1) / 64),
+                              corrupt(100, 3), corrupt(1000, 16)}) {
+        EXPECT_THROW(tile_map_view<float>{copy}, std::invalid_argument);
+    }
+    std::span<std::byte const> const header_only{bytes.data(), 32};
+    EXPECT_THROW(tile_map_view<float>{header_only}, std::invalid_argument);
+}
+
+TEST(SerializeTest, TileGridRoundTrips) {
+    hex_grid<std::uint16_t> terrain{hex<int>{-4, 9}, 33, 17};
+    for (std::size_t i = 0; i < terrain.size(); ++i) {
+        terrain.data()[i] = static_cast<std::uint16_t>(i * 7);
+    }
+    std::stringstream stream;
+    save_tile_grid(stream, terrain);
+    auto const bytes = bytes_of(stream);
+
+    tile_grid_view<std::uint16_t> const view{bytes};
+    EXPECT_EQ(view.origin(), terrain.origin());
+    EXPECT_EQ(view.width(), 33);
+    EXPECT_EQ(view.height(), 17);
+    for (std::size_t i = 0; i < terrain.size(); ++i) {
+        auto const h = terrain.hex_at(i);
+        EXPECT_EQ(view[h], terrain[h]);
+    }
+    EXPECT_EQ(view.row(3)[5], terrain.row(3)[5]);
+    EXPECT_THROW(view.at(hex<int>{-5, 9}), std::out_of_range);
+
+    auto const loaded = view.load();
+    EXPECT_TRUE(std::equal(loaded.begin(), loaded.end(), terrain.begin()));
+
+    std::span<std::byte const> const truncated{bytes.data(), bytes.size() - 1};
+    EXPECT_THROW(tile_grid_view<std::uint16_t>{truncated},
+                 std::invalid_argument);
+    EXPECT_THROW(tile_grid_view<std::uint32_t>{bytes}, std::invalid_argument);
+}
+
+TEST(SerializeTest, CorruptGridHeadersAreRejected) {
+    // with 16-byte tiles, a 2^30 by 2^30 grid needs exactly 2^64 bytes
+    struct wide { std::uint64_t low, high; };
+    hex_grid<wide> values{hex<int>{0, 0}, 2, 1};
+    values.fill(wide{1, 2});
+    std::stringstream stream;
+    save_tile_grid(stream, values);
+    auto const bytes = bytes_of(stream);
+    ASSERT_NO_THROW(tile_grid_view<wide>{bytes});
+
+    // width and height sit at the end of the header
+    auto const corrupt = [&](std::int32_t width, std::int32_t height) {
+        auto copy = bytes;
+        std::memcpy(copy.data() + 24, &width, sizeof(width));
+        std::memcpy(copy.data() + 28, &height, sizeof(height));
+        return copy;
+    };
+    std::int32_t const big = 1 << 30;
+    std::int32_t const huge = std::numeric_limits<std::int32_t>::max();
+    for (auto const & copy : {corrupt(big, big), corrupt(huge, huge),
+                              corrupt(big, 4), corrupt(3, 1), corrupt(-1, 1)}) {
+        EXPECT_THROW(tile_grid_view<wide>{copy},
+                     std::invalid_argument);
+    }
+}
@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <random>
+#include <vector>
+#include <utility>
+#include <unordered_set>
+#include <cstdint>
+
+using namespace tess;
+
+TEST(SightTest, NothingBlocksAdjacentTiles) {
+    auto const always = [](hex<int> const &) { return true; };
+    EXPECT_TRUE(line_of_sight(hex<int>::zero, hex<int>::zero, always));
+    EXPECT_TRUE(line_of_sight(hex<int>::zero, hex<int>::right_down, always));
+}
+
+TEST(SightTest, StopsAtFirstBlocker) {
+    hex<int> const a{0, 0};
+    hex<int> const b{8, 0};
+    std::vector<hex<int>> visited;
+    bool const visible = line_of_sight(a, b, [&](hex<int> const & h) {
+        visited.push_back(h);
+        return h == hex<int>{3, 0};
+    });
+    EXPECT_FALSE(visible);
+    ASSERT_EQ(visited.size(), 3);
+    EXPECT_EQ(visited.back(), hex<int>(3, 0));
+}
+
+TEST(SightTest, VisitsSameHexesAsLine) {
+    std::mt19937 rng{27};
+    std::uniform_int_distribution<int> coord{-40, 40};
+    for (int i = 0; i < 200; ++i) {
+        hex<int> const a{coord(rng), coord(rng)};
+        hex<int> const b{coord(rng), coord(rng)};
+
+        std::vector<hex<int>> expected;
+        line(a, b, std::back_inserter(expected));
+
+        std::vector<hex<int>> visited;
+        line_of_sight(a, b, [&](hex<int> const & h) {
+            visited.push_back(h);
+            return false;
+        });
+        if (expected.size() <= 2) {
+            EXPECT_TRUE(visited.empty());
+        }
+        else {
+            std::vector<hex<int>> const inner(expected.begin()+1,
+                                              expected.end()-1);
+            EXPECT_EQ(visited, inner);
+        }
+    }
+}
+
+TEST(SightTest, BatchedMaskMatchesSingleQueries) {
+    std::mt19937 rng{72};
+    std::uniform_int_distribution<int> coord{-15, 15};
+    std::uniform_int_distribution<int> coin{0, 9};
+
+    std::unordered_set<hex<int>> walls;
+    for (int q = -15; q <= 15; ++q) {
+        for (int r = -15; r <= 15; ++r) {
+            if (coin(rng) == 0) {
+                walls.insert(hex<int>{q, r});
+            }
+        }
+    }
+    auto const is_wall = [&](hex<int> const & h) { return walls.contains(h); };
+
+    std::vector<std::pair<hex<int>, hex<int>>> segments;
+    for (int i = 0; i < 150; ++i) {
+        segments.emplace_back(hex<int>{coord(rng), coord(rng)},
+                              hex<int>{coord(rng), coord(rng)});
+    }
+
+    std::vector<std::uint64_t> mask;
+    lines_of_sight(segments.begin(), segments.end(), is_wall,
+                   std::back_inserter(mask));
+    ASSERT_EQ(mask.size(), 3);
+    EXPECT_EQ(mask[2] >> 22, 0);
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        auto const & [a, b] = segments[i];
+        bool const bit = (mask[i/64] >> (i%64)) & 1;
+        EXPECT_EQ(bit, line_of_sight(a, b, is_wall));
+    }
+}
@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <random>
+#include <vector>
+
+using namespace tess;
+
+namespace {
+hex_grid<double> naive_stencil(hex_grid<double> const & from,
+                               hex_kernel<double> const & kernel)
+{
+    hex_grid<double> into{from.origin(), from.width(), from.height()};
+    for (std::size_t i = 0; i < from.size(); ++i) {
+        auto const h = from.hex_at(i);
+        double total = 0;
+        for (std::size_t t = 0; t < kernel.offsets().size(); ++t) {
+            auto const n = h + kernel.offsets()[t];
+            if (from.contains(n)) {
+                total += kernel.weights()[t] * from[n];
+            }
+        }
+        into[h] = total;
+    }
+    return into;
+}
+}
+
+TEST(StencilTest, KernelFollowsHexRange) {
+    hex_kernel<float> const kernel{2, [](hex<int> const & offset) {
+        return static_cast<float>(hex_norm(offset));
+    }};
+    std::vector<hex<int>> range;
+    hex_range(hex<int>::zero, 2, std::back_inserter(range));
+    ASSERT_EQ(kernel.offsets().size(), range.size());
+    for (std::size_t i = 0; i < range.size(); ++i) {
+        EXPECT_EQ(kernel.offsets()[i], range[i]);
+        EXPECT_EQ(kernel.weights()[i], hex_norm(range[i]));
+    }
+    EXPECT_THROW((hex_kernel<float>{1, std::vector<float>(3)}),
+                 std::invalid_argument);
+    EXPECT_THROW((hex_kernel<float>{-1, std::vector<float>{}}),
+                 std::invalid_argument);
+}
+
+TEST(StencilTest, MatchesNaiveSums) {
+    std::mt19937 random{3};
+    std::uniform_real_distribution<double> value{-1, 1};
+    for (int k = 0; k <= 3; ++k) {
+        std::vector<double> weights;
+        for (int i = 0; i < 3*k*(k+1) + 1; ++i) {
+            weights.push_back(value(random));
+        }
+        hex_kernel<double> const kernel{k, weights};
+        for (auto [w, h] : {std::pair{37, 19}, std::pair{4, 9}, std::pair{1, 1},
+                            std::pair{0, 3}}) {
+            hex_grid<double> grid{hex<int>{-5, 8}, w, h};
+            for (auto & tile : grid) {
+                tile = value(random);
+            }
+            auto const expected = naive_stencil(grid, kernel);
+            auto const actual = apply_stencil(grid, kernel, 3);
+            for (std::size_t i = 0; i < grid.size(); ++i) {
+                EXPECT_NEAR(actual.data()[i], expected.data()[i], 1e-12);
+            }
+        }
+    }
+}
+
+TEST(StencilTest, GridsNarrowerThanTheKernel) {
+    // every column of these grids is an edge column, so the inner span is
+    // empty; run under -fsanitize=undefined to catch stray pointer offsets
+    hex_kernel<double> const kernel{2, std::vector<double>(19, 0.5)};
+    for (auto [w, h] : {std::pair{1, 5}, std::pair{2, 4}, std::pair{3, 3},
+                        std::pair{0, 2}, std::pair{4, 0}}) {
+        hex_grid<double> grid{hex<int>{2, -1}, w, h};
+        double next = 1;
+        for (auto & tile : grid) {
+            tile = next++;
+        }
+        auto const expected = naive_stencil(grid, kernel);
+        auto const actual = apply_stencil(grid, kernel, 2);
+        for (std::size_t i = 0; i < grid.size(); ++i) {
+            EXPECT_DOUBLE_EQ(actual.data()[i], expected.data()[i]);
+        }
+    }
+}
+
+TEST(StencilTest, DiffusionConservesInTheInterior) {
+    hex_grid<float> heat{hex<int>::zero, 41, 41};
+    hex<int> const center{20, 20};
+    heat[center] = 1.f;
+    auto const spread = diffusion_kernel(0.3f);
+    hex_grid<float> next{heat.origin(), heat.width(), heat.height()};
+    for (int tick = 0; tick < 10; ++tick) {
+        apply_stencil(heat, spread, next);
+        std::swap(heat, next);
+    }
+    float total = 0;
+    for (auto tile : heat) {
+        total += tile;
+    }
+    EXPECT_NEAR(total, 1.f, 1e-5f);
+    hex<int> const east{3, 0};
+    hex<int> const north{0, -3};
+    EXPECT_FLOAT_EQ(heat[center + east], heat[center + north]);
+
+    EXPECT_THROW(apply_stencil(heat, spread, heat), std::invalid_argument);
+    hex_grid<float> smaller{hex<int>::zero, 40, 41};
+    EXPECT_THROW(apply_stencil(heat, spread, smaller), std::invalid_argument);
+}
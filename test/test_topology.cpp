@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <random>
+#include <vector>
+#include <set>
+#include <tuple>
+#include <algorithm>
+#include <iterator>
+#include <climits>
+
+using namespace tess;
+
+namespace {
+template<HexWrap WrapStyle>
+int brute_distance(hex_topology<WrapStyle> const & world,
+                   hex<int> const & a, hex<int> const & b)
+{
+    int best = INT_MAX;
+    int const rows = WrapStyle == HexWrap::Torus? 2 : 0;
+    for (int i = -2; i <= 2; ++i) {
+        for (int j = -rows; j <= rows; ++j) {
+            hex<int> const image = world.wrap(b)
+                                 + hex<int>{i * world.width(),
+                                            j * world.height()};
+            best = std::min(best, hex_norm(image - world.wrap(a)));
+        }
+    }
+    return best;
+}
+
+struct row_major {
+    bool operator()(hex<int> const & a, hex<int> const & b) const
+    {
+        return std::tie(a.r, a.q) < std::tie(b.r, b.q);
+    }
+};
+
+template<HexWrap WrapStyle>
+void check_topology(hex_topology<WrapStyle> const & world, unsigned seed)
+{
+    std::mt19937 random{seed};
+    std::uniform_int_distribution<int> q{-3 * world.width(), 3 * world.width()};
+    std::uniform_int_distribution<int> r{0, world.height() - 1};
+    for (int n = 0; n < 2000; ++n) {
+        hex<int> const a = world.origin() + hex<int>{q(random), r(random)};
+        hex<int> const b = world.origin() + hex<int>{q(random), r(random)};
+        EXPECT_EQ(world.distance(a, b), brute_distance(world, a, b));
+
+        std::vector<hex<int>> path;
+        world.line(a, b, std::back_inserter(path));
+        // like line, a line of length zero still writes both ends
+        ASSERT_EQ(path.size(), std::max(world.distance(a, b) + 1, 2));
+        EXPECT_EQ(path.front(), world.wrap(a));
+        EXPECT_EQ(path.back(), world.wrap(b));
+        bool const moves = world.wrap(a) != world.wrap(b);
+        for (std::size_t i = 1; moves and i < path.size(); ++i) {
+            EXPECT_EQ(world.distance(path[i-1], path[i]), 1);
+        }
+    }
+
+    for (int radius : {0, 2, 5, 9}) {
+        hex<int> const center = world.wrap(world.origin() + hex<int>{-1, 1});
+        std::vector<hex<int>> range;
+        world.range(center, radius, std::back_inserter(range));
+
+        std::set<hex<int>, row_major> expected;
+        for (int y = 0; y < world.height(); ++y) {
+            for (int x = 0; x < world.width(); ++x) {
+                auto const h = world.origin() + hex<int>{x, y};
+                if (brute_distance(world, center, h) <= radius) {
+                    expected.insert(h);
+                }
+            }
+        }
+        std::set<hex<int>, row_major> const found(range.begin(), range.end());
+        EXPECT_EQ(found.size(), range.size());
+        EXPECT_EQ(found, expected);
+    }
+}
+}
+
+TEST(TopologyTest, CylinderWrapsColumns) {
+    hex_cylinder const world{hex<int>{-5, 2}, 12, 8};
+    EXPECT_EQ(world.wrap(hex<int>{7, 3}), hex<int>(-5, 3));
+    EXPECT_EQ(world.wrap(hex<int>{-6, 3}), hex<int>(6, 3));
+    EXPECT_EQ(world.wrap(hex<int>{-5 + 12 * 40, 20}), hex<int>(-5, 20));
+    EXPECT_TRUE(world.contains(hex<int>{1000, 2}));
+    EXPECT_FALSE(world.contains(hex<int>{0, 10}));
+    EXPECT_EQ(world.distance(hex<int>{-5, 4}, hex<int>{6, 4}), 1);
+    check_topology(world, 1);
+    EXPECT_THROW((hex_cylinder{hex<int>::zero, 0, 3}), std::invalid_argument);
+}
+
+TEST(TopologyTest, TorusWrapsColumnsAndRows) {
+    hex_torus const world{hex<int>{3, -4}, 9, 7};
+    EXPECT_EQ(world.wrap(hex<int>{3, 3}), hex<int>(3, -4));
+    EXPECT_EQ(world.wrap(hex<int>{2, -5}), hex<int>(11, 2));
+    EXPECT_EQ(world.offset(hex<int>{11, 2}, hex<int>{1, 1}), hex<int>(3, -4));
+    EXPECT_EQ(world.distance(hex<int>{3, -4}, hex<int>{11, 2}), 2);
+    EXPECT_EQ(world.distance(hex<int>{3, -4}, hex<int>{11, -3}), 1);
+    check_topology(world, 2);
+}
@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+#include "tess.hpp"
+#include <random>
+#include <vector>
+#include <tuple>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+
+using namespace tess;
+
+namespace {
+std::vector<hex<int>> random_seeds(hex<int> const & origin, int width,
+                                   int height, std::size_t count,
+                                   unsigned seed)
+{
+    std::mt19937 random{seed};
+    std::uniform_int_distribution<int> q{0, width - 1};
+    std::uniform_int_distribution<int> r{0, height - 1};
+    std::vector<hex<int>> seeds;
+    for (std::size_t i = 0; i < count; ++i) {
+        seeds.push_back(origin + hex<int>{q(random), r(random)});
+    }
+    return seeds;
+}
+
+// relax every tile against its neighbors until nothing changes
+voronoi_partition<int> brute_force(hex_grid<int> const & costs,
+                                   std::vector<hex<int>> const & seeds)
+{
+    int const far = std::numeric_limits<int>::max();
+    voronoi_partition<int> cells{
+        hex_grid<std::uint32_t>{costs.origin(), costs.width(), costs.height(),
+                                no_seed},
+        hex_grid<int>{costs.origin(), costs.width(), costs.height(), far}
+    };
+    for (std::uint32_t i = seeds.size(); i-- > 0; ) {
+        cells.seed[seeds[i]] = i;
+        cells.distance[seeds[i]] = 0;
+    }
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (int r = 0; r < costs.height(); ++r) {
+            for (int q = 0; q < costs.width(); ++q) {
+                auto const h = costs.origin() + hex<int>{q, r};
+                if (costs[h] < 0 or cells.distance[h] == 0) {
+                    continue;
+                }
+                for (auto const & d : hex_directions<int>) {
+                    auto const n = h + d;
+                    if (not costs.contains(n) or cells.distance[n] == far) {
+                        continue;
+                    }
+                    std::tuple const through{cells.distance[n] + costs[h],
+                                             cells.seed[n]};
+                    if (through < std::tuple{cells.distance[h],
+                                             cells.seed[h]}) {
+                        std::tie(cells.distance[h], cells.seed[h]) = through;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+    return cells;
+}
+}
+
+TEST(VoronoiTest, TilesGoToTheNearestSeed) {
+    hex<int> const origin{-20, 7};
+    int const width = 61;
+    int const height = 43;
+    auto const seeds = random_seeds(origin, width, height, 25, 49);
+    for (unsigned threads : {1u, 4u}) {
+        auto const cells = voronoi(origin, width, height, seeds, threads);
+        for (int r = 0; r < height; ++r) {
+            for (int q = 0; q < width; ++q) {
+                auto const h = origin + hex<int>{q, r};
+                std::tuple best{std::numeric_limits<int>::max(), no_seed};
+                for (std::uint32_t i = 0; i < seeds.size(); ++i) {
+                    best = std::min(best, std::tuple{hex_norm(h - seeds[i]), i});
+                }
+                EXPECT_EQ(cells.distance[h], std::get<0>(best));
+                EXPECT_EQ(cells.seed[h], std::get<1>(best));
+            }
+        }
+    }
+}
+
+TEST(VoronoiTest, EmptyAndInvalidInputs) {
+    auto const none = voronoi(hex<int>::zero, 5, 4, std::vector<hex<int>>{});
+    for (auto const seed : none.seed) {
+        EXPECT_EQ(seed, no_seed);
+    }
+    EXPECT_THROW(voronoi(hex<int>::zero, 5, 4,
+                         std::vector<hex<int>>{{5, 0}}),
+                 std::out_of_range);
+    EXPECT_THROW(voronoi(hex<int>::zero, -1, 4, std::vector<hex<int>>{}),
+                 std::invalid_argument);
+
+    // a repeated seed belongs to its first index
+    auto const twice = voronoi(hex<int>::zero, 3, 3,
+                               std::vector<hex<int>>{{1, 1}, {1, 1}});
+    for (auto const seed : twice.seed) {
+        EXPECT_EQ(seed, 0u);
+    }
+}
+
+TEST(VoronoiTest, WeightedMatchesBruteForce) {
+    std::mt19937 random{50};
+    std::uniform_int_distribution<int> cost{-2, 9};
+    hex<int> const origin{3, -4};
+    hex_grid<int> costs{origin, 30, 24};
+    for (auto & c : costs) {
+        c = cost(random);
+    }
+    auto const seeds = random_seeds(origin, costs.width(), costs.height(),
+                                    12, 51);
+    auto const cells = voronoi(costs, seeds);
+    auto const expected = brute_force(costs, seeds);
+    EXPECT_TRUE(std::ranges::equal(cells.distance, expected.distance));
+    EXPECT_TRUE(std::ranges::equal(cells.seed, expected.seed));
+
+    // walled off tiles are left without a seed
+    hex_grid<int> walled{hex<int>::zero, 5, 1, 1};
+    walled[hex<int>{2, 0}] = -1;
+    auto const split = voronoi(walled, std::vector<hex<int>>{{0, 0}});
+    EXPECT_EQ(split.seed[(hex<int>{1, 0})], 0u);
+    EXPECT_EQ(split.seed[(hex<int>{3, 0})], no_seed);
+    EXPECT_EQ(split.distance[(hex<int>{4, 0})],
+              std::numeric_limits<int>::max());
+}